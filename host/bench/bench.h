@@ -0,0 +1,28 @@
+#pragma once
+// Wall-clock micro-benchmark helper for the host build. Numbers are only
+// comparable between runs on the same machine; they say nothing about
+// cycle counts on the keyboard MCU.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "shim.h"
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Keeps the optimiser from discarding a result
+static volatile uint32_t bench_sink;
+
+#define BENCH(label, iterations, ...)                                        \
+    do {                                                                     \
+        uint64_t start_ = bench_now_ns();                                    \
+        for (uint32_t i = 0; i < (uint32_t)(iterations); i++) {              \
+            __VA_ARGS__                                                      \
+        }                                                                    \
+        uint64_t ns_ = bench_now_ns() - start_;                              \
+        printf("%-40s %10.1f ns/op\n", label, (double)ns_ / (iterations));   \
+    } while (0)
@@ -0,0 +1,74 @@
+#include "bench.h"
+#include "feature/leader/leader_hash.h"
+
+// Lookup cost at 25, 250 and 1000 registered sequences: the sorted index
+// should keep it near-flat as sequences.def grows, where the linear
+// leader_hash_is() chain it replaced re-hashes every same-length entry
+
+#define N 200000
+
+static leader_seq_t table[1000];
+static uint16_t table_count;
+static uint32_t found;
+static bool linear;
+
+void leader_hash_end_user(void) {
+    if (!linear) {
+        if (leader_hash_lookup() != NULL) found++;
+        return;
+    }
+
+    // The old dispatch: one leader_hash_is() per sequence, in order
+    for (uint16_t j = 0; j < table_count; j++) {
+        if (leader_hash_is(table[j].keys, table[j].length)) {
+            found++;
+            return;
+        }
+    }
+}
+
+// Distinct 2..5 key sequences over A..Z
+static void fill(uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t v = i;
+        uint8_t len = (uint8_t)(2 + i % 4);
+        table[i].length = len;
+        table[i].action = "";
+        for (uint8_t k = 0; k < len; k++) {
+            table[i].keys[k] = (uint16_t)(KC_A + v % 26);
+            v /= 26;
+        }
+        table[i].hash = leader_hash_generate(table[i].keys, len);
+    }
+    leader_hash_register(table, count);
+    table_count = count;
+}
+
+static void run(uint16_t count, bool use_linear) {
+    char label[48];
+    fill(count);
+    found = 0;
+    linear = use_linear;
+    snprintf(label, sizeof(label), "leader %s, %u entries", use_linear ? "linear" : "sorted", count);
+    BENCH(label, N, {
+        const leader_seq_t *seq = &table[(i * 7919u) % count];
+        leader_hash_start();
+        for (uint8_t k = 0; k < seq->length && leader_hash_active(); k++) {
+            leader_hash_add(seq->keys[k]);
+        }
+        if (leader_hash_active()) leader_hash_end();
+    });
+    bench_sink += found;
+    if (found != N) printf("  (%u of %u sequences matched)\n", found, N);
+}
+
+int main(void) {
+    shim_reset();
+    run(25, true);
+    run(25, false);
+    run(250, true);
+    run(250, false);
+    run(1000, true);
+    run(1000, false);
+    return 0;
+}
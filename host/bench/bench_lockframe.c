@@ -0,0 +1,113 @@
+#include "bench.h"
+#include <string.h>
+#include "lib/ipc/lockframe.h"
+
+// Throughput and error rate of lockframe over a simulated host. The sender
+// runs first with every LED report logged, then the log is replayed into a
+// fresh instance as the receiver. Time is virtual: bytes/s is what the
+// keyboards would see at the given host echo delay, not host CPU speed.
+
+#define FRAMES   200
+#define LOG_MAX  (FRAMES * 160)
+
+static struct {
+    uint32_t ms;
+    uint8_t leds;
+} reports[LOG_MAX];
+static uint32_t report_count, start_ms, rng = 1;
+static uint32_t rx_bytes, rx_frames, rx_corrupt;
+static uint8_t payload[LOCKFRAME_MAX_PAYLOAD];
+
+void lockframe_on_receive(uint8_t type, const uint8_t *data, uint8_t len) {
+    (void)type;
+    rx_frames++;
+    rx_bytes += len;
+    if (len != sizeof(payload) || memcmp(data, payload, len) != 0) rx_corrupt++;
+}
+
+static void record(uint8_t leds) {
+    if (report_count < LOG_MAX) {
+        reports[report_count].ms = shim_ms() - start_ms;
+        reports[report_count].leds = leds;
+        report_count++;
+    }
+    lockstate_led_update(leds);
+}
+
+// xorshift32, so noise rates per million resolve properly
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+// noise: host lock toggles from elsewhere, per million ms
+static void run(uint16_t echo, uint16_t jitter, uint32_t noise) {
+    static const uint8_t locks[] = { KC_NUM_LOCK, KC_CAPS_LOCK, KC_SCROLL_LOCK };
+
+    shim_reset();
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    lockframe_init();
+    shim_led_delay_ms = echo;
+    shim_led_jitter_ms = jitter;
+    shim_led_listener = record;
+    report_count = 0;
+    start_ms = shim_ms();
+    for (uint8_t i = 0; i < sizeof(payload); i++) payload[i] = (uint8_t)next_rand();
+
+    uint32_t attempts = 0;
+    while (attempts < FRAMES) {
+        if (!lockframe_busy() && lockframe_send(LOCKFRAME_COUNTER, payload, sizeof(payload))) {
+            attempts++;
+        }
+        if (noise && next_rand() % 1000000u < noise) shim_host_toggle(locks[next_rand() % 3]);
+        lockstate_task();
+        lockframe_task();
+        shim_advance_ms(1);
+    }
+    while (lockframe_busy()) {
+        lockstate_task();
+        lockframe_task();
+        shim_advance_ms(1);
+    }
+    uint32_t elapsed = shim_ms() - start_ms;
+    uint32_t aborted = lockframe_stats()->aborted;
+
+    shim_reset();
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    lockframe_init();
+    // The receiver only listens: its own writes would not reach the log
+    shim_led_echo = false;
+    rx_bytes = rx_frames = rx_corrupt = 0;
+    uint32_t base = shim_ms(), next = 0;
+    uint32_t end = elapsed + 2 * LOCKFRAME_IDLE_MS;
+    for (uint32_t t = 0; t <= end; t++) {
+        while (next < report_count && reports[next].ms == t) {
+            shim_set_led_state((led_t){ .raw = reports[next].leds });
+            lockstate_led_update(reports[next].leds);
+            next++;
+        }
+        lockstate_task();
+        lockframe_task();
+        shim_set_ms(base + t + 1);
+    }
+
+    const lockframe_stats_t *rx = lockframe_stats();
+    uint32_t lost = attempts - (rx_frames - rx_corrupt);
+    printf("echo %2ums jitter %ums noise %4u/Mms  %6.1f bytes/s  "
+           "error %5.1f%%  (abort %u, crc %u, len %u, timeout %u, bad payload %u)\n",
+           echo, jitter, noise, rx_bytes * 1000.0 / elapsed, 100.0 * lost / attempts,
+           aborted, rx->bad_checksum, rx->bad_length, rx->timeouts, rx_corrupt);
+}
+
+int main(void) {
+    run(1, 0, 0);
+    run(2, 0, 0);
+    run(4, 0, 0);
+    run(8, 0, 0);
+    run(2, 4, 0);
+    run(2, 0, 100);
+    run(2, 0, 1000);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+#include <math.h>
+#include "lib/pointing/cursor.h"
+#include "lib/pointing/subpixel.h"
+#include "lib/pointing/scroll.h"
+#include "lib/pointing/gestures.h"
+
+#define N 1000000
+
+// Motion spread over the interesting part of the curve
+static int16_t dx(uint32_t i) { return (int16_t)((int32_t)(i * 7919u % 121u) - 60); }
+static int16_t dy(uint32_t i) { return (int16_t)((int32_t)(i * 104729u % 121u) - 60); }
+
+static void float_accel(int16_t *x, int16_t *y) {
+    float speed = sqrtf((float)*x * *x + (float)*y * *y);
+    if (speed <= CURSOR_ACCEL_OFFSET) return;
+    float factor = 1.0f + powf(speed - CURSOR_ACCEL_OFFSET, 2) * 0.001f * CURSOR_ACCEL_SLOPE;
+    if (factor > CURSOR_ACCEL_LIMIT) factor = CURSOR_ACCEL_LIMIT;
+    *x = (int16_t)(*x * factor);
+    *y = (int16_t)(*y * factor);
+}
+
+int main(void) {
+    shim_reset();
+
+    BENCH("accel float reference", N, {
+        int16_t x = dx(i), y = dy(i);
+        float_accel(&x, &y);
+        bench_sink += (uint32_t)(x + y);
+    });
+
+    BENCH("accel gain table", N, {
+        int16_t x = dx(i), y = dy(i);
+        cursor_apply_acceleration(&x, &y);
+        bench_sink += (uint32_t)(x + y);
+    });
+
+    subpixel_t sp;
+    subpixel_init(&sp);
+    BENCH("accel q8 + subpixel", N, {
+        int32_t qx, qy;
+        int16_t x, y;
+        cursor_accelerate_q8(dx(i), dy(i), &qx, &qy);
+        subpixel_add_q8(&sp, qx, qy);
+        subpixel_take(&sp, &x, &y, 127);
+        bench_sink += (uint32_t)(x + y);
+    });
+
+    scroll_state_t scroll;
+    scroll_init(&scroll, SCROLL_SENSITIVITY_Q8, 120);
+    BENCH("scroll accumulate + consume", N, {
+        int16_t h, v;
+        shim_advance_ms(1);
+        scroll_accumulate(&scroll, dx(i), dy(i));
+        scroll_coast(&scroll);
+        scroll_consume(&scroll, &h, &v, HV_REPORT_MAX);
+        bench_sink += (uint32_t)(h + v);
+    });
+
+    gesture_detector_t gesture;
+    gesture_init(&gesture, 450, 300, false);
+    BENCH("gesture detect", N, {
+        shim_advance_ms(1);
+        bench_sink += gesture_detect(&gesture, (int16_t)(dx(i) / 8), (int16_t)(dy(i) / 8));
+    });
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "bench.h"
+#include "util/send_packed.h"
+#include "util/send_queue.h"
+
+#define N 20000
+
+static const char text[] = "git commit -m \"Refactor the pointing pipeline\"\n";
+
+int main(void) {
+    shim_reset();
+
+    BENCH("send_string (serial reports)", N, {
+        shim_reset();
+        send_string(text);
+        bench_sink += shim_report_count;
+    });
+    printf("  %u reports per string\n", shim_report_count);
+
+    BENCH("send_packed_string", N, {
+        shim_reset();
+        send_packed_string(text);
+        bench_sink += shim_report_count;
+    });
+    printf("  %u reports per string\n", shim_report_count);
+
+    uint32_t scans = 0;
+    BENCH("send_queue push + drain", N, {
+        shim_reset();
+        send_queue_push(text);
+        while (send_queue_busy()) {
+            send_queue_task();
+            scans++;
+        }
+    });
+    printf("  %u scans per string\n", scans / N);
+
+    return 0;
+}
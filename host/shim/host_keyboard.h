@@ -0,0 +1,4 @@
+#pragma once
+// QMK_KEYBOARD_H for host builds
+#include "quantum.h"
+#include "print.h"
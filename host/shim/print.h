@@ -0,0 +1,3 @@
+#pragma once
+// Console output is captured, see shim_console()
+void uprintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
@@ -0,0 +1,225 @@
+#pragma once
+// Host stand-in for the subset of QMK the shared libraries use.
+// Behaviour lives in shim.c; tests drive and inspect it through shim.h.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Progmem
+// ---------------------------------------------------------------------------
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+
+// ---------------------------------------------------------------------------
+// Keycodes
+// ---------------------------------------------------------------------------
+
+enum host_keycodes {
+    KC_NO = 0x00,
+    KC_TRANSPARENT = 0x01,
+    KC_A = 0x04, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1 = 0x1E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENTER = 0x28, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE,
+    KC_MINUS = 0x2D, KC_EQUAL, KC_LEFT_BRACKET, KC_RIGHT_BRACKET, KC_BACKSLASH,
+    KC_SEMICOLON = 0x33, KC_QUOTE, KC_GRAVE, KC_COMMA, KC_DOT, KC_SLASH,
+    KC_CAPS_LOCK = 0x39,
+    KC_F1 = 0x3A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+    KC_PRINT_SCREEN = 0x46, KC_SCROLL_LOCK, KC_PAUSE,
+    KC_HOME = 0x4A, KC_PAGE_UP, KC_DELETE, KC_END, KC_PAGE_DOWN,
+    KC_RIGHT = 0x4F, KC_LEFT, KC_DOWN, KC_UP,
+    KC_NUM_LOCK = 0x53,
+    KC_LEFT_CTRL = 0xE0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI,
+    KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI
+};
+
+#define KC_TRNS KC_TRANSPARENT
+#define KC_ENT  KC_ENTER
+#define KC_SPC  KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_PGUP KC_PAGE_UP
+#define KC_PGDN KC_PAGE_DOWN
+
+#define IS_MODIFIER_KEYCODE(k) ((k) >= KC_LEFT_CTRL && (k) <= KC_RIGHT_GUI)
+
+#define QK_USER_0   0x7E40
+#define QK_USER_MAX 0x7FFF
+
+typedef struct {
+    struct {
+        bool pressed;
+        uint16_t time;
+    } event;
+} keyrecord_t;
+
+// ---------------------------------------------------------------------------
+// Timer (virtual clock, see shim_advance_ms)
+// ---------------------------------------------------------------------------
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+void wait_ms(uint16_t ms);
+uint32_t last_input_activity_elapsed(void);
+
+// ---------------------------------------------------------------------------
+// Key output
+// ---------------------------------------------------------------------------
+
+// As in QMK, tap_code() holds Caps Lock for TAP_HOLD_CAPS_DELAY and other
+// keys for TAP_CODE_DELAY; the shim advances the virtual clock by as much
+#ifndef TAP_CODE_DELAY
+#define TAP_CODE_DELAY 0
+#endif
+#ifndef TAP_HOLD_CAPS_DELAY
+#define TAP_HOLD_CAPS_DELAY 80
+#endif
+
+void tap_code(uint8_t keycode);
+void tap_code16(uint16_t keycode);
+void register_code(uint8_t keycode);
+void unregister_code(uint8_t keycode);
+
+#define KEYBOARD_REPORT_KEYS 6
+
+typedef struct {
+    bool nkro;
+} keymap_config_t;
+
+extern keymap_config_t keymap_config;
+
+void add_key(uint8_t keycode);
+void del_key(uint8_t keycode);
+void send_keyboard_report(void);
+
+uint8_t ascii_to_keycode(char c);
+bool ascii_to_shift(char c);
+bool ascii_to_altgr(char c);
+
+void send_char(char c);
+void send_string(const char *str);
+void send_string_P(const char *str);
+#define SEND_STRING(s) send_string_P(PSTR(s))
+
+// SEND_STRING encoding, as in send_string.h
+#define SS_QMK_PREFIX 1
+#define SS_TAP_CODE   1
+#define SS_DOWN_CODE  2
+#define SS_UP_CODE    3
+#define SS_DELAY_CODE 4
+
+#define X_ENTER "\x28"
+#define X_TAB   "\x2b"
+#define X_RIGHT "\x4f"
+#define X_LEFT  "\x50"
+#define X_LCTL  "\xe0"
+#define X_LSFT  "\xe1"
+#define X_LALT  "\xe2"
+#define X_F2    "\x3b"
+
+#define SS_TAP(k)   "\1\1" k
+#define SS_DOWN(k)  "\1\2" k
+#define SS_UP(k)    "\1\3" k
+#define SS_DELAY(ms) "\1\4" #ms "|"
+#define SS_LCTL(s)  SS_DOWN(X_LCTL) s SS_UP(X_LCTL)
+#define SS_LSFT(s)  SS_DOWN(X_LSFT) s SS_UP(X_LSFT)
+#define SS_LALT(s)  SS_DOWN(X_LALT) s SS_UP(X_LALT)
+
+// ---------------------------------------------------------------------------
+// Host LEDs
+// ---------------------------------------------------------------------------
+
+typedef union {
+    uint8_t raw;
+    struct {
+        bool num_lock : 1;
+        bool caps_lock : 1;
+        bool scroll_lock : 1;
+        bool compose : 1;
+        bool kana : 1;
+        uint8_t reserved : 3;
+    };
+} led_t;
+
+led_t host_keyboard_led_state(void);
+
+// ---------------------------------------------------------------------------
+// Layers
+// ---------------------------------------------------------------------------
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+
+void layer_on(uint8_t layer);
+void layer_off(uint8_t layer);
+void layer_clear(void);
+uint8_t get_highest_layer(layer_state_t state);
+
+// ---------------------------------------------------------------------------
+// RGB matrix
+// ---------------------------------------------------------------------------
+
+#ifndef RGB_MATRIX_LED_COUNT
+#define RGB_MATRIX_LED_COUNT 72
+#endif
+
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} HSV;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} RGB;
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+} led_point_t;
+
+typedef struct {
+    led_point_t point[RGB_MATRIX_LED_COUNT];
+    uint8_t flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+
+#define LED_FLAG_NONE      0x00
+#define LED_FLAG_KEYLIGHT  0x04
+
+#define RGB_MATRIX_SOLID_COLOR 1
+
+extern led_config_t g_led_config;
+
+RGB hsv_to_rgb(HSV hsv);
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+uint8_t rgb_matrix_get_mode(void);
+HSV rgb_matrix_get_hsv(void);
+
+// ---------------------------------------------------------------------------
+// Pointing device
+// ---------------------------------------------------------------------------
+
+#include "report.h"
+
+void pointing_device_set_cpi(uint16_t cpi);
+uint16_t pointing_device_get_cpi(void);
+uint16_t pointing_device_get_hires_scroll_resolution(void);
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+typedef int16_t mouse_xy_report_t;
+typedef int16_t mouse_hv_report_t;
+
+#define XY_REPORT_MIN INT16_MIN
+#define XY_REPORT_MAX INT16_MAX
+#define HV_REPORT_MIN INT16_MIN
+#define HV_REPORT_MAX INT16_MAX
+
+typedef struct {
+    uint8_t buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
+} report_mouse_t;
@@ -0,0 +1,398 @@
+#include "shim.h"
+#include "print.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+
+static uint32_t now_ms = SHIM_BOOT_MS;
+static uint32_t activity_ms = 0;
+
+static void led_tick(void);
+
+void shim_set_ms(uint32_t ms) { now_ms = ms; }
+
+// One ms at a time so delayed LED echoes land on their own tick
+void shim_advance_ms(uint32_t ms) {
+    while (ms--) {
+        now_ms++;
+        led_tick();
+    }
+}
+
+uint32_t shim_ms(void) { return now_ms; }
+void shim_set_activity(uint32_t ms_ago) { activity_ms = now_ms - ms_ago; }
+
+uint16_t timer_read(void) { return (uint16_t)now_ms; }
+uint32_t timer_read32(void) { return now_ms; }
+uint16_t timer_elapsed(uint16_t last) { return (uint16_t)(now_ms - last); }
+uint32_t timer_elapsed32(uint32_t last) { return now_ms - last; }
+void wait_ms(uint16_t ms) { shim_advance_ms(ms); }
+uint32_t last_input_activity_elapsed(void) { return now_ms - activity_ms; }
+
+// ---------------------------------------------------------------------------
+// Keyboard
+// ---------------------------------------------------------------------------
+
+uint16_t shim_taps[SHIM_LOG_SIZE];
+uint16_t shim_tap_count = 0;
+uint32_t shim_report_count = 0;
+keymap_config_t keymap_config = { .nkro = false };
+
+static uint8_t keys[32];          // Bitmap of held keycodes
+static uint8_t sent_keys[32];     // As of the last report
+static uint8_t mods = 0;
+static char typed[SHIM_LOG_SIZE];
+static uint16_t typed_len = 0;
+
+// US layout, 0x20..0x7E: keycode and whether shift is needed
+static const uint8_t ascii_keycode[95] = {
+    KC_SPACE, KC_1, KC_QUOTE, KC_3, KC_4, KC_5, KC_7, KC_QUOTE,
+    KC_9, KC_0, KC_8, KC_EQUAL, KC_COMMA, KC_MINUS, KC_DOT, KC_SLASH,
+    KC_0, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7,
+    KC_8, KC_9, KC_SEMICOLON, KC_SEMICOLON, KC_COMMA, KC_EQUAL, KC_DOT, KC_SLASH,
+    KC_2, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G,
+    KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O,
+    KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+    KC_X, KC_Y, KC_Z, KC_LEFT_BRACKET, KC_BACKSLASH, KC_RIGHT_BRACKET, KC_6, KC_MINUS,
+    KC_GRAVE, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G,
+    KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O,
+    KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+    KC_X, KC_Y, KC_Z, KC_LEFT_BRACKET, KC_BACKSLASH, KC_RIGHT_BRACKET, KC_GRAVE,
+};
+
+static const char ascii_shifted[] = "!\"#$%&()*+:<>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ^_{|}~";
+
+uint8_t ascii_to_keycode(char c) {
+    if (c == '\n') return KC_ENTER;
+    if (c == '\t') return KC_TAB;
+    if (c == '\b') return KC_BACKSPACE;
+    if (c < 0x20 || c > 0x7E) return KC_NO;
+    return ascii_keycode[c - 0x20];
+}
+
+bool ascii_to_shift(char c) {
+    return c != '\0' && strchr(ascii_shifted, c) != NULL;
+}
+
+bool ascii_to_altgr(char c) {
+    (void)c;
+    return false;
+}
+
+// Inverse of the table above, for reconstructing typed text
+static char keycode_to_ascii(uint8_t keycode, bool shifted) {
+    if (keycode == KC_ENTER) return '\n';
+    if (keycode == KC_TAB) return '\t';
+    for (char c = 0x20; c <= 0x7E; c++) {
+        if (ascii_keycode[c - 0x20] == keycode && ascii_to_shift(c) == shifted) return c;
+    }
+    return '?';
+}
+
+static bool key_held(const uint8_t *map, uint8_t keycode) {
+    return map[keycode >> 3] & (1 << (keycode & 7));
+}
+
+void add_key(uint8_t keycode) {
+    keys[keycode >> 3] |= (uint8_t)(1 << (keycode & 7));
+}
+
+void del_key(uint8_t keycode) {
+    keys[keycode >> 3] &= (uint8_t)~(1 << (keycode & 7));
+}
+
+void send_keyboard_report(void) {
+    bool shifted = mods & 0x22;
+    for (uint16_t k = KC_A; k < KC_LEFT_CTRL; k++) {
+        if (key_held(keys, k) && !key_held(sent_keys, k) && typed_len < SHIM_LOG_SIZE - 1) {
+            typed[typed_len++] = keycode_to_ascii((uint8_t)k, shifted);
+        }
+    }
+    memcpy(sent_keys, keys, sizeof(keys));
+    shim_report_count++;
+}
+
+static uint8_t lock_bit_of(uint8_t keycode);
+static void lock_press(uint8_t keycode);
+
+static void press(uint8_t keycode) {
+    lock_press(keycode);
+    if (IS_MODIFIER_KEYCODE(keycode)) {
+        mods |= (uint8_t)(1 << (keycode - KC_LEFT_CTRL));
+    } else {
+        add_key(keycode);
+    }
+    send_keyboard_report();
+}
+
+void register_code(uint8_t keycode) {
+    if (lock_bit_of(keycode) && shim_tap_count < SHIM_LOG_SIZE) shim_taps[shim_tap_count++] = keycode;
+    press(keycode);
+}
+
+void unregister_code(uint8_t keycode) {
+    if (IS_MODIFIER_KEYCODE(keycode)) {
+        mods &= (uint8_t)~(1 << (keycode - KC_LEFT_CTRL));
+    } else {
+        del_key(keycode);
+    }
+    send_keyboard_report();
+}
+
+static led_t led_state = { .raw = 0 };
+bool shim_led_echo = true;
+uint16_t shim_led_delay_ms = 0;
+uint16_t shim_led_jitter_ms = 0;
+void (*shim_led_listener)(uint8_t leds) = NULL;
+
+// Host-side toggles waiting for their echo; the host applies them in order
+#define LED_QUEUE 64
+static struct {
+    uint32_t due;
+    uint8_t bit;
+} led_queue[LED_QUEUE];
+static uint8_t led_head = 0, led_count = 0;
+static uint32_t led_rng = 1;
+
+static uint8_t lock_bit_of(uint8_t keycode) {
+    switch (keycode) {
+        case KC_NUM_LOCK:    return 0b001;
+        case KC_CAPS_LOCK:   return 0b010;
+        case KC_SCROLL_LOCK: return 0b100;
+        default:             return 0;
+    }
+}
+
+static void led_queue_toggle(uint8_t bit) {
+    if (led_count == LED_QUEUE) return;
+    uint32_t due = now_ms + shim_led_delay_ms;
+    if (shim_led_jitter_ms) {
+        led_rng = led_rng * 1103515245u + 12345u;
+        due += (led_rng >> 16) % (shim_led_jitter_ms + 1u);
+    }
+    if (led_count) {
+        uint32_t last = led_queue[(led_head + led_count - 1) % LED_QUEUE].due;
+        if ((int32_t)(due - last) < 0) due = last;
+    }
+    led_queue[(led_head + led_count) % LED_QUEUE].due = due;
+    led_queue[(led_head + led_count) % LED_QUEUE].bit = bit;
+    led_count++;
+}
+
+// Everything that came due this ms reaches the keyboard as one report
+static void led_tick(void) {
+    uint8_t before = led_state.raw;
+    while (led_count && (int32_t)(now_ms - led_queue[led_head].due) >= 0) {
+        led_state.raw ^= led_queue[led_head].bit;
+        led_head = (led_head + 1) % LED_QUEUE;
+        led_count--;
+    }
+    if (led_state.raw != before && shim_led_listener) shim_led_listener(led_state.raw);
+}
+
+void shim_host_toggle(uint8_t keycode) {
+    led_state.raw ^= lock_bit_of(keycode);
+    if (shim_led_listener) shim_led_listener(led_state.raw);
+}
+
+// The host toggles a lock on key down, whether tapped or held
+static void lock_press(uint8_t keycode) {
+    uint8_t bit = lock_bit_of(keycode);
+    if (shim_led_echo && bit) {
+        if (shim_led_delay_ms || shim_led_jitter_ms) {
+            led_queue_toggle(bit);
+        } else {
+            led_state.raw ^= bit;
+        }
+    }
+}
+
+void tap_code(uint8_t keycode) {
+    if (shim_tap_count < SHIM_LOG_SIZE) shim_taps[shim_tap_count++] = keycode;
+    press(keycode);
+    // QMK blocks here for the hold; the whole keyboard waits with it
+    shim_advance_ms(keycode == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+    unregister_code(keycode);
+}
+
+void tap_code16(uint16_t keycode) {
+    tap_code((uint8_t)keycode);
+}
+
+void send_char(char c) {
+    uint8_t keycode = ascii_to_keycode(c);
+    bool shift = ascii_to_shift(c);
+    if (shift) register_code(KC_LEFT_SHIFT);
+    register_code(keycode);
+    unregister_code(keycode);
+    if (shift) unregister_code(KC_LEFT_SHIFT);
+}
+
+void send_string(const char *str) {
+    while (*str) send_char(*str++);
+}
+
+void send_string_P(const char *str) {
+    send_string(str);
+}
+
+const char *shim_typed(void) {
+    typed[typed_len] = '\0';
+    return typed;
+}
+
+uint8_t shim_mods(void) {
+    return mods;
+}
+
+// ---------------------------------------------------------------------------
+// Host LEDs
+// ---------------------------------------------------------------------------
+
+led_t host_keyboard_led_state(void) { return led_state; }
+void shim_set_led_state(led_t state) { led_state = state; }
+
+// ---------------------------------------------------------------------------
+// Layers
+// ---------------------------------------------------------------------------
+
+layer_state_t layer_state = 0;
+
+void layer_on(uint8_t layer) { layer_state |= (layer_state_t)1 << layer; }
+void layer_off(uint8_t layer) { layer_state &= ~((layer_state_t)1 << layer); }
+void layer_clear(void) { layer_state = 0; }
+uint8_t get_highest_layer(layer_state_t state) { return state ? 31 - __builtin_clz(state) : 0; }
+
+// ---------------------------------------------------------------------------
+// RGB matrix
+// ---------------------------------------------------------------------------
+
+RGB shim_leds[RGB_MATRIX_LED_COUNT];
+uint32_t shim_rgb_writes = 0;
+uint8_t shim_rgb_mode = RGB_MATRIX_SOLID_COLOR;
+HSV shim_rgb_hsv = { 0, 255, 255 };
+led_config_t g_led_config;
+
+// Two 6x6 halves spread over QMK's 224x64 LED space
+static void init_led_config(void) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        uint8_t half = i / 36, cell = i % 36;
+        g_led_config.point[i].x = (uint8_t)(half * 128 + (cell % 6) * 19);
+        g_led_config.point[i].y = (uint8_t)((cell / 6) * 12);
+        g_led_config.flags[i] = LED_FLAG_KEYLIGHT;
+    }
+}
+
+// Same integer conversion as QMK's color.c
+RGB hsv_to_rgb(HSV hsv) {
+    RGB rgb;
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = hsv.v;
+        return rgb;
+    }
+
+    uint16_t h = hsv.h, s = hsv.s, v = hsv.v;
+    uint8_t region = (uint8_t)(h * 6 / 255);
+    uint8_t remainder = (uint8_t)((h * 2 - region * 85) * 3);
+    uint8_t p = (uint8_t)((v * (255 - s)) >> 8);
+    uint8_t q = (uint8_t)((v * (255 - ((s * remainder) >> 8))) >> 8);
+    uint8_t t = (uint8_t)((v * (255 - ((s * (255 - remainder)) >> 8))) >> 8);
+
+    switch (region) {
+        case 6:
+        case 0: rgb = (RGB){ (uint8_t)v, t, p }; break;
+        case 1: rgb = (RGB){ q, (uint8_t)v, p }; break;
+        case 2: rgb = (RGB){ p, (uint8_t)v, t }; break;
+        case 3: rgb = (RGB){ p, q, (uint8_t)v }; break;
+        case 4: rgb = (RGB){ t, p, (uint8_t)v }; break;
+        default: rgb = (RGB){ (uint8_t)v, p, q }; break;
+    }
+    return rgb;
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index < 0 || index >= RGB_MATRIX_LED_COUNT) return;
+    shim_leds[index] = (RGB){ red, green, blue };
+    shim_rgb_writes++;
+}
+
+uint8_t rgb_matrix_get_mode(void) { return shim_rgb_mode; }
+HSV rgb_matrix_get_hsv(void) { return shim_rgb_hsv; }
+
+// ---------------------------------------------------------------------------
+// Pointing device
+// ---------------------------------------------------------------------------
+
+uint16_t shim_cpi = 0;
+uint32_t shim_cpi_writes = 0;
+uint16_t shim_hires_resolution = 120;
+
+void pointing_device_set_cpi(uint16_t cpi) {
+    shim_cpi = cpi;
+    shim_cpi_writes++;
+}
+
+uint16_t pointing_device_get_cpi(void) { return shim_cpi; }
+uint16_t pointing_device_get_hires_scroll_resolution(void) { return shim_hires_resolution; }
+
+// ---------------------------------------------------------------------------
+// Console
+// ---------------------------------------------------------------------------
+
+static char console[1 << 16];
+static size_t console_len = 0;
+
+void uprintf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(console + console_len, sizeof(console) - console_len, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        console_len += (size_t)n;
+        if (console_len >= sizeof(console)) console_len = sizeof(console) - 1;
+    }
+}
+
+const char *shim_console(void) { return console; }
+
+void shim_console_clear(void) {
+    console_len = 0;
+    console[0] = '\0';
+}
+
+// ---------------------------------------------------------------------------
+// Reset
+// ---------------------------------------------------------------------------
+
+void shim_reset(void) {
+    now_ms = SHIM_BOOT_MS;
+    activity_ms = 0;
+    shim_tap_count = 0;
+    shim_report_count = 0;
+    keymap_config.nkro = false;
+    memset(keys, 0, sizeof(keys));
+    memset(sent_keys, 0, sizeof(sent_keys));
+    mods = 0;
+    typed_len = 0;
+    led_state.raw = 0;
+    shim_led_echo = true;
+    shim_led_delay_ms = 0;
+    shim_led_jitter_ms = 0;
+    shim_led_listener = NULL;
+    led_head = 0;
+    led_count = 0;
+    led_rng = 1;
+    layer_state = 0;
+    memset(shim_leds, 0, sizeof(shim_leds));
+    shim_rgb_writes = 0;
+    shim_rgb_mode = RGB_MATRIX_SOLID_COLOR;
+    shim_rgb_hsv = (HSV){ 0, 255, 255 };
+    init_led_config();
+    shim_cpi = 0;
+    shim_cpi_writes = 0;
+    shim_hires_resolution = 120;
+    shim_console_clear();
+}
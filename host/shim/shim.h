@@ -0,0 +1,58 @@
+#pragma once
+// Test-facing controls for the host QMK shim
+
+#include "quantum.h"
+
+#ifndef SHIM_LOG_SIZE
+#define SHIM_LOG_SIZE 4096
+#endif
+
+// Clock value after shim_reset(); non-zero because leader_hash treats a
+// zero timer stamp as inactive, as a real keyboard never scans at t=0
+#ifndef SHIM_BOOT_MS
+#define SHIM_BOOT_MS 1000
+#endif
+
+// Restore power-on state: clock at SHIM_BOOT_MS, all logs and LEDs cleared
+void shim_reset(void);
+
+// Virtual clock in ms; timer_read() sees the low 16 bits
+void shim_set_ms(uint32_t ms);
+void shim_advance_ms(uint32_t ms);
+uint32_t shim_ms(void);
+void shim_set_activity(uint32_t ms_ago);
+
+// Every tap_code() keycode and lock key press, in order
+extern uint16_t shim_taps[SHIM_LOG_SIZE];
+extern uint16_t shim_tap_count;
+
+// Keyboard reports and the text a US-layout host would have typed
+extern uint32_t shim_report_count;
+const char *shim_typed(void);
+uint8_t shim_mods(void);
+
+// Host LEDs; lock key taps toggle them the way a host echo would
+void shim_set_led_state(led_t state);
+extern bool shim_led_echo;
+// Echo after delay + rand(0..jitter) ms instead of at once; each ms whose
+// echoes change the LEDs is passed to the listener as one LED report
+extern uint16_t shim_led_delay_ms;
+extern uint16_t shim_led_jitter_ms;
+extern void (*shim_led_listener)(uint8_t leds);
+// A lock key pressed on the host itself (another keyboard, an app)
+void shim_host_toggle(uint8_t keycode);
+
+// RGB matrix
+extern RGB shim_leds[RGB_MATRIX_LED_COUNT];
+extern uint32_t shim_rgb_writes;
+extern uint8_t shim_rgb_mode;
+extern HSV shim_rgb_hsv;
+
+// Pointing device
+extern uint16_t shim_cpi;
+extern uint32_t shim_cpi_writes;
+extern uint16_t shim_hires_resolution;
+
+// Captured uprintf() output
+const char *shim_console(void);
+void shim_console_clear(void);
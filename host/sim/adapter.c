@@ -0,0 +1,49 @@
+// One device's view of the world, compiled once per implementation and
+// device with the same SIM_PREFIX as that device's lockstate.c
+
+#include "sim.h"
+#include "quantum.h"
+
+#if defined(SIM_IMPL_ipc)
+#    include "lib/ipc/lockstate.h"
+#elif defined(SIM_IMPL_shared)
+#    include "shared/lockstate/lockstate.h"
+#else
+#    error "SIM_IMPL_ipc or SIM_IMPL_shared must be defined"
+#endif
+
+void tap_code(uint8_t keycode) {
+    sim_tap(SIM_DEVICE, keycode);
+}
+
+// The host toggles a lock on the press
+void register_code(uint8_t keycode) {
+    sim_tap(SIM_DEVICE, keycode);
+}
+
+void unregister_code(uint8_t keycode) {}
+
+led_t host_keyboard_led_state(void) {
+    return (led_t){ .raw = sim_view(SIM_DEVICE) };
+}
+
+void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
+    sim_on_remote_change(SIM_DEVICE, old_state, new_state);
+}
+
+void lockstate_on_sync_request(void) {
+    sim_on_sync_request(SIM_DEVICE);
+}
+
+static void api_init(uint8_t role) { lockstate_init((lock_role_t)role); }
+static void api_set(uint8_t state) { lockstate_set((lock_state_t)state); }
+static uint8_t api_cached(void) { return lockstate_cached(); }
+
+const sim_device_api_t SIM_NAME(sim_api) = {
+    .init = api_init,
+    .set = api_set,
+    .task = lockstate_task,
+    .led_update = lockstate_led_update,
+    .sync_request = lockstate_sync_request,
+    .cached = api_cached,
+};
@@ -0,0 +1,317 @@
+// Two-device lockstate simulator.
+//
+// A PRIMARY and a SECONDARY run side by side against one virtual host.
+// A lock tap toggles the host LEDs at once; each device sees the result
+// after its own echo delay + jitter, in order, one LED report per ms (as
+// the shim does for a single device). Both devices share the shim clock
+// and are ticked every ms, as two keyboards on one machine would be.
+//
+// Scripted layer/mode changes are replayed per implementation, with and
+// without LED report events, over a few echo settings. For every script
+// step it measures:
+//
+//   converge   ms until host, both views and both caches agree on a state
+//              the step asked for; steps that never get there by the next
+//              one are counted as unconverged
+//   extra      lock taps beyond the Hamming distance the step needed, which
+//              is what conflict rewrites and abandoned writes cost
+//   spurious   remote-change callbacks for a state no step asked for, i.e.
+//              intermediate or colliding states a peer acted on
+//
+// A toggle that finds a device's echo queue full is counted as an overflow
+// and fails the run: that device's view would silently drift from the host.
+// Scripts marked settled must also converge on every step with LED events
+// wired, at every echo setting, or the run fails.
+
+#include "sim.h"
+#include "shim.h"
+#include <stdio.h>
+#include <string.h>
+
+#define QUEUE 64
+#define SETTLE_MS 1500  // Run-out after the last step
+
+// ---------------------------------------------------------------------------
+// Devices
+// ---------------------------------------------------------------------------
+
+extern const sim_device_api_t ipc_a_sim_api, ipc_b_sim_api;
+extern const sim_device_api_t shared_a_sim_api, shared_b_sim_api;
+
+typedef struct {
+    const char *name;
+    const sim_device_api_t *dev[SIM_DEVICES];
+} sim_impl_t;
+
+static const sim_impl_t impls[] = {
+    { "shared", { &shared_a_sim_api, &shared_b_sim_api } },
+    { "ipc",    { &ipc_a_sim_api,    &ipc_b_sim_api } },
+};
+
+enum { ROLE_PRIMARY, ROLE_SECONDARY };  // lock_role_t, in both implementations
+
+static const sim_device_api_t *const *api;
+static bool events;
+
+static uint8_t host;
+static uint32_t rng;
+
+static struct {
+    uint8_t view;
+    uint8_t queue[QUEUE];  // Lock bits to toggle in the view, in order
+    uint32_t due[QUEUE];
+    uint8_t head, count;
+} dev[SIM_DEVICES];
+
+static uint32_t taps, callbacks_spurious, callbacks, overflows;
+static uint8_t accepted;  // Bitmask of states the current step asked for
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint16_t echo_ms, jitter_ms;
+
+static void host_toggle(uint8_t bit) {
+    host ^= bit;
+    for (uint8_t d = 0; d < SIM_DEVICES; d++) {
+        if (dev[d].count == QUEUE) {
+            overflows++;
+            continue;
+        }
+        uint32_t due = shim_ms() + echo_ms;
+        if (jitter_ms) due += next_rand() % (jitter_ms + 1u);
+        if (dev[d].count) {
+            uint32_t last = dev[d].due[(dev[d].head + dev[d].count - 1) % QUEUE];
+            if (due < last) due = last;
+        }
+        uint8_t at = (dev[d].head + dev[d].count) % QUEUE;
+        dev[d].due[at] = due;
+        dev[d].queue[at] = bit;
+        dev[d].count++;
+    }
+}
+
+static uint8_t lock_bit(uint8_t keycode) {
+    switch (keycode) {
+        case KC_NUM_LOCK:    return 0b001;
+        case KC_CAPS_LOCK:   return 0b010;
+        case KC_SCROLL_LOCK: return 0b100;
+        default:             return 0;
+    }
+}
+
+void sim_tap(uint8_t d, uint8_t keycode) {
+    uint8_t bit = lock_bit(keycode);
+    if (!bit) return;
+    taps++;
+    host_toggle(bit);
+}
+
+uint8_t sim_view(uint8_t d) {
+    return dev[d].view;
+}
+
+void sim_on_remote_change(uint8_t d, uint8_t old_state, uint8_t new_state) {
+    callbacks++;
+    if (!(accepted & (1 << new_state))) callbacks_spurious++;
+}
+
+void sim_on_sync_request(uint8_t d) {}
+
+static void deliver(void) {
+    for (uint8_t d = 0; d < SIM_DEVICES; d++) {
+        uint8_t before = dev[d].view;
+        while (dev[d].count && (int32_t)(shim_ms() - dev[d].due[dev[d].head]) >= 0) {
+            dev[d].view ^= dev[d].queue[dev[d].head];
+            dev[d].head = (dev[d].head + 1) % QUEUE;
+            dev[d].count--;
+        }
+        if (events && dev[d].view != before) api[d]->led_update(dev[d].view);
+    }
+}
+
+static void tick(void) {
+    deliver();
+    for (uint8_t d = 0; d < SIM_DEVICES; d++) api[d]->task();
+    shim_advance_ms(1);
+}
+
+// Settled on a state the step asked for
+static bool converged(void) {
+    for (uint8_t d = 0; d < SIM_DEVICES; d++) {
+        if (dev[d].view != host || api[d]->cached() != host) return false;
+    }
+    return accepted & (1 << host);
+}
+
+// ---------------------------------------------------------------------------
+// Scripts
+// ---------------------------------------------------------------------------
+
+enum { SET, SYNC };
+
+typedef struct {
+    uint16_t at;  // ms from script start; steps sharing a time collide
+    uint8_t device;
+    uint8_t op;
+    uint8_t state;
+} step_t;
+
+typedef struct {
+    const char *name;
+    bool settled;  // Steps far enough apart that all must converge
+    const step_t *steps;
+    uint8_t count;
+} script_t;
+
+#define SCRIPT(name, settled, ...) \
+    { name, settled, (const step_t[]){ __VA_ARGS__ }, sizeof((step_t[]){ __VA_ARGS__ }) / sizeof(step_t) }
+
+// States as in lock_state_t
+#define IDLE 0
+#define NAV 1
+#define NUM 2
+#define MACRO 3
+#define SCROLL 4
+#define ZOOM 5
+#define MEDIA 6
+
+static const script_t scripts[] = {
+    // Layer changes far apart, from both sides
+    SCRIPT("calm", true,
+        {    0, 0, SET, NAV },   {  300, 0, SET, NUM },   {  600, 0, SET, IDLE },
+        {  900, 1, SET, SCROLL },{ 1200, 1, SET, MEDIA }, { 1500, 0, SET, MACRO },
+        { 1800, 1, SET, ZOOM },  { 2100, 0, SET, IDLE }),
+    // NAV tapped quickly on the keyboard
+    SCRIPT("nav taps", false,
+        {    0, 0, SET, NAV },   {   60, 0, SET, IDLE },  {  120, 0, SET, NAV },
+        {  180, 0, SET, IDLE },  {  240, 0, SET, NAV },   {  300, 0, SET, IDLE },
+        {  360, 0, SET, NUM },   {  420, 0, SET, NAV },   {  480, 0, SET, IDLE }),
+    // Both devices change mode in the same ms
+    SCRIPT("collide", false,
+        {    0, 0, SET, NAV },   {    0, 1, SET, SCROLL },
+        {  600, 0, SET, NUM },   {  600, 1, SET, MEDIA },
+        { 1200, 0, SET, IDLE },  { 1200, 1, SET, ZOOM }),
+    // Secondary resets the line, then the keyboard changes layer again
+    SCRIPT("sync", false,
+        {    0, 0, SET, NUM },   {  300, 1, SYNC, IDLE }, { 1800, 0, SET, NAV },
+        { 2100, 0, SET, IDLE }),
+};
+
+// ---------------------------------------------------------------------------
+// Runs
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t steps, unconverged, conv_total, conv_max;
+    uint32_t taps, extra, spurious, callbacks;
+} result_t;
+
+static void run_script(const script_t *s, result_t *r) {
+    shim_reset();
+    memset(dev, 0, sizeof(dev));
+    host = 0;
+    rng = 0x5eed1234u;
+    accepted = 1 << IDLE;
+    api[0]->init(ROLE_PRIMARY);
+    api[1]->init(ROLE_SECONDARY);
+    for (int i = 0; i < 100; i++) tick();
+
+    uint32_t start = shim_ms();
+    for (uint8_t i = 0; i < s->count;) {
+        while (shim_ms() - start < s->steps[i].at) tick();
+
+        // All steps at this time are one group
+        uint8_t from = host;
+        uint32_t group_taps = taps, group_callbacks = callbacks, group_spurious = callbacks_spurious;
+        bool sync = false;
+        accepted = 0;
+        uint8_t last = i;
+        for (; last < s->count && s->steps[last].at == s->steps[i].at; last++) {
+            const step_t *st = &s->steps[last];
+            accepted |= 1 << st->state;
+            if (st->op == SYNC) {
+                sync = true;
+                api[st->device]->sync_request();
+            } else {
+                api[st->device]->set(st->state);
+            }
+        }
+
+        uint32_t end = last < s->count ? start + s->steps[last].at : shim_ms() + SETTLE_MS;
+        uint32_t t0 = shim_ms(), conv = 0;
+        bool done = false;
+        while (shim_ms() < end) {
+            tick();
+            if (!done && converged()) {
+                done = true;
+                conv = shim_ms() - t0;
+            }
+        }
+
+        r->steps++;
+        if (done) {
+            r->conv_total += conv;
+            if (conv > r->conv_max) r->conv_max = conv;
+        } else {
+            r->unconverged++;
+        }
+        // A sync goes through 111 and back down to 000
+        uint32_t needed = sync ? __builtin_popcount(from ^ 0b111) + 3 : __builtin_popcount(from ^ host);
+        uint32_t used = taps - group_taps;
+        r->taps += used;
+        r->extra += used > needed ? used - needed : 0;
+        r->callbacks += callbacks - group_callbacks;
+        r->spurious += callbacks_spurious - group_spurious;
+        i = last;
+    }
+}
+
+// Returns false if an echo queue overflowed, or a settled script with
+// events did not converge
+static bool run(const script_t *s, const sim_impl_t *impl, bool with_events, uint16_t echo, uint16_t jitter) {
+    result_t r = { 0 };
+    api = impl->dev;
+    events = with_events;
+    echo_ms = echo;
+    jitter_ms = jitter;
+    taps = callbacks = callbacks_spurious = overflows = 0;
+    run_script(s, &r);
+
+    uint32_t converged_steps = r.steps - r.unconverged;
+    printf("  %-6s %-6s echo %2ums jitter %2ums  converge mean %5.1fms max %4ums  "
+           "unconverged %u/%u  taps %3u extra %3u  spurious %2u/%u\n",
+           impl->name, with_events ? "events" : "polled", echo, jitter,
+           converged_steps ? (double)r.conv_total / converged_steps : 0.0, r.conv_max,
+           r.unconverged, r.steps, r.taps, r.extra, r.spurious, r.callbacks);
+    if (overflows) {
+        printf("  !! %u echo queue overflows, results above are invalid\n", overflows);
+        return false;
+    }
+    if (s->settled && with_events && r.unconverged) {
+        printf("  !! %u/%u steps of a settled script never converged\n", r.unconverged, r.steps);
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    static const uint16_t echoes[][2] = { { 1, 0 }, { 4, 0 }, { 8, 4 }, { 16, 8 } };
+    bool ok = true;
+
+    for (size_t s = 0; s < sizeof(scripts) / sizeof(scripts[0]); s++) {
+        printf("%s\n", scripts[s].name);
+        for (size_t i = 0; i < sizeof(impls) / sizeof(impls[0]); i++) {
+            for (int with_events = 1; with_events >= 0; with_events--) {
+                for (size_t e = 0; e < sizeof(echoes) / sizeof(echoes[0]); e++) {
+                    ok &= run(&scripts[s], &impls[i], with_events, echoes[e][0], echoes[e][1]);
+                }
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
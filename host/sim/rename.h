@@ -0,0 +1,37 @@
+#pragma once
+// Force-included into every per-device object of the simulator. Each
+// device's copy of a lockstate implementation gets its own prefix
+// (SIM_PREFIX, e.g. ipc_a_), so two instances of the same globals can
+// live in one process. The QMK calls a device makes are renamed too and
+// resolved per device by sim/adapter.c.
+
+#define SIM_CAT_(a, b) a##b
+#define SIM_CAT(a, b) SIM_CAT_(a, b)
+#define SIM_NAME(name) SIM_CAT(SIM_PREFIX, name)
+
+// lockstate API and state, in both implementations
+#define lockstate                   SIM_NAME(lockstate)
+#define lockstate_init              SIM_NAME(lockstate_init)
+#define lockstate_set               SIM_NAME(lockstate_set)
+#define lockstate_write             SIM_NAME(lockstate_write)
+#define lockstate_writing           SIM_NAME(lockstate_writing)
+#define lockstate_settle_ms         SIM_NAME(lockstate_settle_ms)
+#define lockstate_get               SIM_NAME(lockstate_get)
+#define lockstate_task              SIM_NAME(lockstate_task)
+#define lockstate_led_update        SIM_NAME(lockstate_led_update)
+#define lockstate_cached            SIM_NAME(lockstate_cached)
+#define lockstate_is_owned          SIM_NAME(lockstate_is_owned)
+#define lockstate_sync_request      SIM_NAME(lockstate_sync_request)
+#define lockstate_name              SIM_NAME(lockstate_name)
+#define lockstate_elapsed           SIM_NAME(lockstate_elapsed)
+#define lockstate_on_remote_change  SIM_NAME(lockstate_on_remote_change)
+#define lockstate_on_sync_request   SIM_NAME(lockstate_on_sync_request)
+#define lockstate_intercept         SIM_NAME(lockstate_intercept)
+#define lockstate_log_change        SIM_NAME(lockstate_log_change)
+#define lockstate_debug_dump        SIM_NAME(lockstate_debug_dump)
+
+// QMK calls that touch the host
+#define tap_code                    SIM_NAME(tap_code)
+#define register_code               SIM_NAME(register_code)
+#define unregister_code             SIM_NAME(unregister_code)
+#define host_keyboard_led_state     SIM_NAME(host_keyboard_led_state)
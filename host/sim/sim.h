@@ -0,0 +1,24 @@
+#pragma once
+// Interface between the simulator driver and the per-device adapters.
+// Only plain integer types cross it: each adapter sees its own
+// implementation's lockstate.h, and the driver sees none.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SIM_DEVICES 2
+
+typedef struct {
+    void (*init)(uint8_t role);
+    void (*set)(uint8_t state);
+    void (*task)(void);
+    void (*led_update)(uint8_t leds);
+    void (*sync_request)(void);
+    uint8_t (*cached)(void);
+} sim_device_api_t;
+
+// Provided by the driver, called by the adapters on behalf of device dev
+void sim_tap(uint8_t dev, uint8_t keycode);
+uint8_t sim_view(uint8_t dev);
+void sim_on_remote_change(uint8_t dev, uint8_t old_state, uint8_t new_state);
+void sim_on_sync_request(uint8_t dev);
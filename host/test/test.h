@@ -0,0 +1,57 @@
+#pragma once
+// Minimal assertion helpers for the host tests. Each test file is its own
+// program: TEST() defines a case, RUN() calls it, and main returns
+// test_summary() so make stops on the first failing file.
+
+#include <stdio.h>
+#include "shim.h"
+
+static int test_failures = 0;
+static int test_checks = 0;
+static const char *test_current = "";
+
+#define TEST(name) static void name(void)
+
+#define RUN(name)                \
+    do {                         \
+        shim_reset();            \
+        test_current = #name;    \
+        name();                  \
+    } while (0)
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        test_checks++;                                                      \
+        if (!(cond)) {                                                      \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: %s: CHECK(%s) failed\n",                \
+                    __FILE__, __LINE__, test_current, #cond);               \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                      \
+    do {                                                                    \
+        long long a_ = (long long)(a), b_ = (long long)(b);                 \
+        test_checks++;                                                      \
+        if (a_ != b_) {                                                     \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: %s: %s == %lld, expected %s == %lld\n", \
+                    __FILE__, __LINE__, test_current, #a, a_, #b, b_);      \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_STR(a, b)                                                     \
+    do {                                                                    \
+        const char *a_ = (a), *b_ = (b);                                    \
+        test_checks++;                                                      \
+        if (strcmp(a_, b_) != 0) {                                          \
+            test_failures++;                                                \
+            fprintf(stderr, "%s:%d: %s: %s == \"%s\", expected \"%s\"\n",   \
+                    __FILE__, __LINE__, test_current, #a, a_, b_);          \
+        }                                                                   \
+    } while (0)
+
+static inline int test_summary(const char *file) {
+    printf("%-28s %4d checks, %d failed\n", file, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#include "test.h"
+#include <math.h>
+
+// Built into this program so the test can reach breathing_sine(); the
+// Makefile leaves breathing.c out of its source list
+#include "feature/rgb/breathing.c"
+
+TEST(quarter_table_matches_sinf) {
+    for (uint16_t phase = 0; phase < PHASE_STEPS; phase++) {
+        float want = 255.0f * sinf(2.0f * (float)M_PI * phase / PHASE_STEPS);
+        int   got  = breathing_sine(phase);
+        if (fabsf(got - want) > 1.0f) {
+            fprintf(stderr, "phase %u: %d, sinf %.2f\n", phase, got, want);
+            CHECK(false);
+        }
+    }
+    CHECK_EQ(breathing_sine(0), 0);
+    CHECK_EQ(breathing_sine(PHASE_STEPS / 4), 255);
+    CHECK_EQ(breathing_sine(3 * PHASE_STEPS / 4), -255);
+}
+
+TEST(brightness_stays_in_range) {
+    breathing_init();
+    for (uint32_t ms = 0; ms < BREATHING_PERIOD_MS; ms += 7) {
+        uint8_t val = breathing_get_val();
+        CHECK(val >= BREATHING_MIN_VAL && val <= BREATHING_MAX_VAL);
+        shim_advance_ms(7);
+    }
+}
+
+int main(void) {
+    RUN(quarter_table_matches_sinf);
+    RUN(brightness_stays_in_range);
+    return test_summary(__FILE__);
+}
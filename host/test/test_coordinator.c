@@ -0,0 +1,164 @@
+#include "test.h"
+#include "shared/lockstate/coordinator.h"
+#include "lib/core/layers.h"
+
+static void run_ms(uint32_t ms) {
+    while (ms--) {
+        coordinator_task();
+        shim_advance_ms(1);
+    }
+}
+
+// The Ploopy writes a state; the Moonlander picks it up on its next poll
+static void ploopy_shows(lock_state_t state) {
+    shim_set_led_state((led_t){ .raw = state });
+    run_ms(LOCKSTATE_POLL_INTERVAL + 1);
+}
+
+static bool press(uint16_t keycode) {
+    keyrecord_t record = { .event = { .pressed = true } };
+    return coordinator_process_key(keycode, &record);
+}
+
+static void begin(void) {
+    coordinator_init();
+    run_ms(10);
+    shim_tap_count = 0;
+}
+
+TEST(held_layer_is_broadcast_after_the_hold) {
+    begin();
+    coordinator_on_layer_change(_NAV);
+    run_ms(COORDINATOR_BROADCAST_HOLD - 1);
+    CHECK_EQ(shim_tap_count, 0);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+
+    run_ms(2);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NAV);
+    CHECK_EQ(coordinator_get_state(), LOCK_STATE_ML_NAV);
+    CHECK_EQ(coordinator_suppressed_broadcasts(), 0);
+}
+
+TEST(tapped_layer_never_reaches_the_host) {
+    begin();
+    for (int i = 0; i < 5; i++) {
+        coordinator_on_layer_change(_NAV);
+        run_ms(COORDINATOR_BROADCAST_HOLD / 2);
+        coordinator_on_layer_change(_BASE);
+        run_ms(COORDINATOR_BROADCAST_HOLD / 2);
+    }
+    run_ms(2 * COORDINATOR_BROADCAST_HOLD);
+    CHECK_EQ(shim_tap_count, 0);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+    // Each tap saves the NAV write and the IDLE write after it
+    CHECK_EQ(coordinator_suppressed_broadcasts(), 10);
+}
+
+TEST(newer_layer_replaces_the_queued_one) {
+    begin();
+    coordinator_on_layer_change(_NAV);
+    run_ms(COORDINATOR_BROADCAST_HOLD / 2);
+    coordinator_on_layer_change(_NUM);
+    // The hold restarts for the new state
+    run_ms(COORDINATOR_BROADCAST_HOLD - 1);
+    CHECK_EQ(shim_tap_count, 0);
+    run_ms(2);
+    CHECK_EQ(shim_tap_count, 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NUM);
+    CHECK_EQ(coordinator_suppressed_broadcasts(), 1);
+}
+
+TEST(release_from_a_broadcast_layer_is_held_too) {
+    begin();
+    coordinator_on_layer_change(_NUM);
+    run_ms(COORDINATOR_BROADCAST_HOLD + 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NUM);
+
+    // Leaving NUM for a moment does not bounce the Ploopy
+    coordinator_on_layer_change(_BASE);
+    run_ms(COORDINATOR_BROADCAST_HOLD / 4);
+    coordinator_on_layer_change(_NUM);
+    run_ms(2 * COORDINATOR_BROADCAST_HOLD);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NUM);
+    CHECK_EQ(coordinator_suppressed_broadcasts(), 2);
+}
+
+TEST(macro_state_outranks_a_queued_layer) {
+    begin();
+    coordinator_on_layer_change(_NAV);
+    coordinator_on_macro_change(true);
+    // Written at once: Num on this task, Caps on the next
+    run_ms(2);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_MACRO);
+    run_ms(2 * COORDINATOR_BROADCAST_HOLD);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_MACRO);
+    CHECK_EQ(coordinator_suppressed_broadcasts(), 1);
+}
+
+TEST(unlisted_layers_broadcast_idle) {
+    begin();
+    coordinator_on_layer_change(_NAV);
+    run_ms(COORDINATOR_BROADCAST_HOLD + 1);
+    coordinator_on_layer_change(_FUNC);
+    run_ms(COORDINATOR_BROADCAST_HOLD + 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+    coordinator_on_layer_change(_LAYER_COUNT + 3);
+    run_ms(COORDINATOR_BROADCAST_HOLD + 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+}
+
+TEST(ploopy_media_layer_is_not_answered) {
+    begin();
+    ploopy_shows(LOCK_STATE_PA_MEDIA);
+    CHECK(coordinator_ploopy_media());
+    CHECK(layer_state & (1UL << _MEDIA));
+
+    // The layer the Ploopy turned on comes back through layer_state_set_user
+    coordinator_on_layer_change(_MEDIA);
+    run_ms(2 * COORDINATOR_BROADCAST_HOLD);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_PA_MEDIA);
+    CHECK(coordinator_ploopy_media());
+
+    // IDLE is a Moonlander state, taken from the Ploopy only once stale
+    ploopy_shows(LOCK_STATE_IDLE);
+    run_ms(LOCKSTATE_TIMEOUT);
+    CHECK(!coordinator_ploopy_media());
+    CHECK(!(layer_state & (1UL << _MEDIA)));
+}
+
+TEST(scroll_mode_remaps_vertical_arrows) {
+    begin();
+    CHECK(press(KC_UP));
+    CHECK(!coordinator_keys_overridden());
+
+    ploopy_shows(LOCK_STATE_PA_SCROLL);
+    CHECK(coordinator_ploopy_scrolling());
+    CHECK(coordinator_keys_overridden());
+    uint16_t taps = shim_tap_count;
+    CHECK(!press(KC_UP));
+    CHECK(!press(KC_DOWN));
+    CHECK(press(KC_LEFT));
+    CHECK(press(KC_A));
+    CHECK_EQ(shim_tap_count, taps + 2);
+    CHECK_EQ(shim_taps[taps], KC_PGUP);
+    CHECK_EQ(shim_taps[taps + 1], KC_PGDN);
+
+    // Zoom has no remaps
+    ploopy_shows(LOCK_STATE_PA_ZOOM);
+    CHECK(!coordinator_ploopy_scrolling());
+    CHECK(coordinator_ploopy_zooming());
+    CHECK(!coordinator_keys_overridden());
+    CHECK(press(KC_UP));
+}
+
+int main(void) {
+    RUN(held_layer_is_broadcast_after_the_hold);
+    RUN(tapped_layer_never_reaches_the_host);
+    RUN(newer_layer_replaces_the_queued_one);
+    RUN(release_from_a_broadcast_layer_is_held_too);
+    RUN(macro_state_outranks_a_queued_layer);
+    RUN(unlisted_layers_broadcast_idle);
+    RUN(ploopy_media_layer_is_not_answered);
+    RUN(scroll_mode_remaps_vertical_arrows);
+    return test_summary(__FILE__);
+}
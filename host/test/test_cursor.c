@@ -0,0 +1,86 @@
+#include "test.h"
+#include <math.h>
+#include "lib/pointing/cursor.h"
+#include "lib/pointing/subpixel.h"
+#include "lib/pointing/sensor.h"
+
+// The float curve the gain table replaced
+static void reference_accel(int16_t *x, int16_t *y) {
+    float speed = sqrtf((float)*x * *x + (float)*y * *y);
+    if (speed <= CURSOR_ACCEL_OFFSET) return;
+    float factor = 1.0f + powf(speed - CURSOR_ACCEL_OFFSET, 2) * 0.001f * CURSOR_ACCEL_SLOPE;
+    if (factor > CURSOR_ACCEL_LIMIT) factor = CURSOR_ACCEL_LIMIT;
+    *x = (int16_t)(*x * factor);
+    *y = (int16_t)(*y * factor);
+}
+
+TEST(gain_table_tracks_float_curve) {
+    int worst = 0;
+    for (int x = -100; x <= 100; x++) {
+        for (int y = -100; y <= 100; y++) {
+            int16_t rx = (int16_t)x, ry = (int16_t)y, cx = (int16_t)x, cy = (int16_t)y;
+            reference_accel(&rx, &ry);
+            cursor_apply_acceleration(&cx, &cy);
+            int e = abs(rx - cx) > abs(ry - cy) ? abs(rx - cx) : abs(ry - cy);
+            if (e > worst) worst = e;
+        }
+    }
+    CHECK(worst <= 1);
+}
+
+TEST(slow_motion_is_untouched) {
+    CHECK_EQ(cursor_gain_q8(3, 4), 256);
+    CHECK_EQ(cursor_gain_q8(1000, 1000), (uint16_t)(CURSOR_ACCEL_LIMIT * 256));
+}
+
+TEST(subpixel_carries_fractions) {
+    subpixel_t sp;
+    int16_t x, y, total = 0;
+    subpixel_init(&sp);
+
+    // 0.5 count per report adds up to whole counts
+    for (int i = 0; i < 10; i++) {
+        subpixel_add_q8(&sp, 128, -128);
+        subpixel_take(&sp, &x, &y, 127);
+        total += x;
+        CHECK_EQ(x, -y);
+    }
+    CHECK_EQ(total, 5);
+}
+
+TEST(subpixel_spills_past_limit) {
+    subpixel_t sp;
+    int16_t x, y;
+    subpixel_init(&sp);
+
+    subpixel_add_q8(&sp, 300L * 256, 0);
+    subpixel_take(&sp, &x, &y, 127);
+    CHECK_EQ(x, 127);
+    subpixel_take(&sp, &x, &y, 127);
+    CHECK_EQ(x, 127);
+    subpixel_take(&sp, &x, &y, 127);
+    CHECK_EQ(x, 300 - 254);
+
+    subpixel_add_q8(&sp, INT32_MAX / 2, 0);
+    CHECK_EQ(sp.x, SUBPIXEL_SPILL_LIMIT);
+}
+
+TEST(precision_overrides_and_restores_cpi) {
+    cursor_state_t c;
+    sensor_cpi_init(1600);
+    cursor_init(&c, 400);
+
+    cursor_set_precision(&c, true);
+    CHECK_EQ(shim_cpi, 400);
+    cursor_set_precision(&c, false);
+    CHECK_EQ(shim_cpi, 1600);
+}
+
+int main(void) {
+    RUN(gain_table_tracks_float_curve);
+    RUN(slow_motion_is_untouched);
+    RUN(subpixel_carries_fractions);
+    RUN(subpixel_spills_past_limit);
+    RUN(precision_overrides_and_restores_cpi);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,125 @@
+#include "test.h"
+#include "lib/pointing/gestures.h"
+
+// Feed n reports of (dx, dy), step_ms apart; returns the report index
+// (1-based) that fired, or 0
+static int feed(gesture_detector_t *d, int16_t dx, int16_t dy, int n, int step_ms, gesture_t *out) {
+    for (int i = 0; i < n; i++) {
+        shim_advance_ms(step_ms);
+        gesture_t g = gesture_detect(d, dx, dy);
+        if (g != GESTURE_NONE) {
+            *out = g;
+            return i + 1;
+        }
+    }
+    *out = GESTURE_NONE;
+    return 0;
+}
+
+TEST(flick_fires_before_the_distance_threshold) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, false);
+
+    int n = feed(&d, 8, 0, 200, 1, &g);
+    CHECK_EQ(g, GESTURE_RIGHT);
+    CHECK(n > 0 && n * 8 < 450);
+}
+
+TEST(slow_drift_never_fires) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, false);
+
+    CHECK_EQ(feed(&d, 1, 0, 2000, 5, &g), 0);
+}
+
+TEST(steady_stroke_fires_on_distance) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 150, 0, false);
+
+    CHECK(feed(&d, 0, 1, 400, 1, &g) > 0);
+    CHECK_EQ(g, GESTURE_DOWN);
+}
+
+TEST(diagonals) {
+    CHECK_EQ(gesture_direction(10, 0), GESTURE_RIGHT);
+    CHECK_EQ(gesture_direction(-10, 3), GESTURE_LEFT);
+    CHECK_EQ(gesture_direction(10, -10), GESTURE_UP_RIGHT);
+    CHECK_EQ(gesture_direction(-10, -10), GESTURE_UP_LEFT);
+    CHECK_EQ(gesture_direction(10, 10), GESTURE_DOWN_RIGHT);
+    CHECK_EQ(gesture_direction(-10, 10), GESTURE_DOWN_LEFT);
+    CHECK_EQ(gesture_direction(3, -10), GESTURE_UP);
+    CHECK_EQ(gesture_direction(0, 0), GESTURE_NONE);
+}
+
+// 30 degrees off the x axis: past the 22.5 degree octant edge
+TEST(slanted_swipe_is_cardinal_for_four_way_callers) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, false);
+
+    CHECK(feed(&d, 26, 15, 100, 1, &g) > 0);
+    CHECK_EQ(g, GESTURE_RIGHT);
+    CHECK_EQ(gesture_cardinal(-15, -26), GESTURE_UP);
+    CHECK_EQ(gesture_cardinal(0, 0), GESTURE_NONE);
+}
+
+TEST(slanted_swipe_is_diagonal_when_enabled) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, true);
+
+    CHECK(feed(&d, 26, 15, 100, 1, &g) > 0);
+    CHECK_EQ(g, GESTURE_DOWN_RIGHT);
+}
+
+TEST(cooldown_blocks_repeat) {
+    gesture_detector_t d;
+    gesture_t g;
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, false);
+
+    feed(&d, 8, 0, 100, 1, &g);
+    CHECK_EQ(g, GESTURE_RIGHT);
+    CHECK_EQ(feed(&d, 8, 0, 100, 1, &g), 0);
+}
+
+TEST(multi_stroke_pattern) {
+    gesture_detector_t d;
+    gesture_t g;
+    const gesture_t pattern[] = { GESTURE_RIGHT, GESTURE_DOWN };
+    shim_set_ms(1000);
+    gesture_init(&d, 450, 300, false);
+
+    feed(&d, 8, 0, 100, 1, &g);
+    CHECK(!gesture_match(&d, pattern, 2));
+    shim_advance_ms(320);
+    feed(&d, 0, 8, 100, 1, &g);
+    CHECK(gesture_match(&d, pattern, 2));
+
+    // Strokes too far apart start a new pattern
+    shim_advance_ms(GESTURE_STROKE_GAP_MS + 1);
+    feed(&d, 8, 0, 100, 1, &g);
+    shim_advance_ms(GESTURE_STROKE_GAP_MS + 1);
+    feed(&d, 0, 8, 100, 1, &g);
+    CHECK(!gesture_match(&d, pattern, 2));
+}
+
+int main(void) {
+    RUN(flick_fires_before_the_distance_threshold);
+    RUN(slow_drift_never_fires);
+    RUN(steady_stroke_fires_on_distance);
+    RUN(diagonals);
+    RUN(slanted_swipe_is_cardinal_for_four_way_callers);
+    RUN(slanted_swipe_is_diagonal_when_enabled);
+    RUN(cooldown_blocks_repeat);
+    RUN(multi_stroke_pattern);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,80 @@
+#include "test.h"
+#include "feature/leader/leader_hash.h"
+
+static const leader_seq_t *matched;
+static bool ended;
+
+void leader_hash_end_user(void) {
+    ended = true;
+    matched = leader_hash_lookup();
+}
+
+#define ENTRY(act, n, ...) \
+    { .hash = 0, .length = n, .action = act, .keys = { __VA_ARGS__ } }
+
+static leader_seq_t table[] = {
+    ENTRY("ab",  2, KC_A, KC_B),
+    ENTRY("ac",  2, KC_A, KC_C),
+    ENTRY("abc", 3, KC_A, KC_B, KC_C),
+    ENTRY("x",   2, KC_X, KC_Y),
+};
+
+static void setup(void) {
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); i++) {
+        table[i].hash = leader_hash_generate(table[i].keys, table[i].length);
+    }
+    leader_hash_register(table, sizeof(table) / sizeof(table[0]));
+    matched = NULL;
+    ended = false;
+}
+
+static void type(const uint16_t *keys, uint8_t n) {
+    leader_hash_start();
+    for (uint8_t i = 0; i < n && leader_hash_active(); i++) {
+        leader_hash_add(keys[i]);
+    }
+}
+
+TEST(unique_match_ends_early) {
+    const uint16_t keys[] = { KC_A, KC_C };
+    setup();
+    type(keys, 2);
+    CHECK(ended);
+    CHECK(matched != NULL && strcmp(matched->action, "ac") == 0);
+}
+
+TEST(ambiguous_prefix_waits_for_timeout) {
+    const uint16_t keys[] = { KC_A, KC_B };
+    setup();
+    type(keys, 2);
+    CHECK(!ended);
+
+    shim_advance_ms(LEADER_HASH_TIMEOUT + 1);
+    leader_hash_task();
+    CHECK(ended);
+    CHECK(matched != NULL && strcmp(matched->action, "ab") == 0);
+}
+
+TEST(longer_sequence_after_prefix) {
+    const uint16_t keys[] = { KC_A, KC_B, KC_C };
+    setup();
+    type(keys, 3);
+    CHECK(ended);
+    CHECK(matched != NULL && strcmp(matched->action, "abc") == 0);
+}
+
+TEST(dead_end_ends_without_match) {
+    const uint16_t keys[] = { KC_A, KC_Z };
+    setup();
+    type(keys, 2);
+    CHECK(ended);
+    CHECK(matched == NULL);
+}
+
+int main(void) {
+    RUN(unique_match_ends_early);
+    RUN(ambiguous_prefix_waits_for_timeout);
+    RUN(longer_sequence_after_prefix);
+    RUN(dead_end_ends_without_match);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,203 @@
+#include "test.h"
+#include "lib/ipc/lockframe.h"
+#include <string.h>
+
+// The sender runs first against the shim host while every LED report is
+// logged; the log is then replayed into a fresh instance as the receiver.
+// Both see the same host LEDs, as two keyboards on one machine would.
+
+#define LOG_MAX 4096
+
+static struct {
+    uint32_t ms;
+    uint8_t leds;
+} reports[LOG_MAX];
+static uint32_t report_count;
+static uint32_t start_ms;
+
+static uint8_t rx_type, rx_len, rx_payload[LOCKFRAME_MAX_PAYLOAD];
+static int rx_frames, remote_changes, sync_requests;
+
+void lockframe_on_receive(uint8_t type, const uint8_t *payload, uint8_t len) {
+    rx_frames++;
+    rx_type = type;
+    rx_len = len;
+    memcpy(rx_payload, payload, len);
+}
+
+void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
+    (void)old_state; (void)new_state;
+    remote_changes++;
+}
+
+void lockstate_on_sync_request(void) {
+    sync_requests++;
+}
+
+static void record(uint8_t leds) {
+    if (report_count < LOG_MAX) {
+        reports[report_count].ms = shim_ms() - start_ms;
+        reports[report_count].leds = leds;
+        report_count++;
+    }
+    lockstate_led_update(leds);
+}
+
+static void tick(void) {
+    lockstate_task();
+    lockframe_task();
+    shim_advance_ms(1);
+}
+
+static void sender_begin(uint16_t echo_ms) {
+    shim_reset();
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    lockframe_init();
+    shim_led_delay_ms = echo_ms;
+    shim_led_listener = record;
+    report_count = 0;
+    start_ms = shim_ms();
+}
+
+static void sender_drain(void) {
+    while (lockframe_busy()) tick();
+    for (int i = 0; i < 10; i++) tick();
+}
+
+// Replays the log, then idles long enough for every timeout to fire
+static void receive(void) {
+    shim_reset();
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    lockframe_init();
+    rx_frames = remote_changes = sync_requests = 0;
+
+    uint32_t base = shim_ms(), next = 0;
+    uint32_t end = (report_count ? reports[report_count - 1].ms : 0) + 2 * LOCKFRAME_IDLE_MS;
+    for (uint32_t t = 0; t <= end; t++) {
+        while (next < report_count && reports[next].ms == t) {
+            shim_set_led_state((led_t){ .raw = reports[next].leds });
+            lockstate_led_update(reports[next].leds);
+            next++;
+        }
+        lockstate_task();
+        lockframe_task();
+        shim_set_ms(base + t + 1);
+    }
+}
+
+TEST(dpi_frame_round_trip) {
+    const uint8_t dpi[] = { 0x40, 0x06 };
+    sender_begin(2);
+    CHECK(lockframe_send(LOCKFRAME_DPI, dpi, sizeof(dpi)));
+    CHECK(!lockframe_send(LOCKFRAME_DPI, dpi, sizeof(dpi)));
+    sender_drain();
+    CHECK_EQ(lockframe_stats()->sent, 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+
+    receive();
+    CHECK_EQ(rx_frames, 1);
+    CHECK_EQ(rx_type, LOCKFRAME_DPI);
+    CHECK_EQ(rx_len, 2);
+    CHECK(memcmp(rx_payload, dpi, 2) == 0);
+    CHECK_EQ(remote_changes, 0);
+    CHECK_EQ(sync_requests, 0);
+}
+
+TEST(frames_resume_the_fast_path_state) {
+    const uint8_t layers[] = { 0x0F, 0x00, 0x01, 0x80 };
+    sender_begin(1);
+    lockstate_set(LOCK_STATE_ML_NUM);
+    sender_drain();
+    CHECK(lockframe_send(LOCKFRAME_LAYERS, layers, sizeof(layers)));
+    sender_drain();
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NUM);
+
+    receive();
+    CHECK_EQ(rx_frames, 1);
+    CHECK_EQ(rx_type, LOCKFRAME_LAYERS);
+    // Only the ML_NUM write itself; the frame and its restore stay hidden
+    CHECK_EQ(remote_changes, 1);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_ML_NUM);
+}
+
+TEST(sequence_numbers_count_gaps) {
+    const uint8_t count[] = { 1, 0, 0, 0 };
+    sender_begin(1);
+    for (int i = 0; i < 3; i++) {
+        CHECK(lockframe_send(LOCKFRAME_COUNTER, count, sizeof(count)));
+        sender_drain();
+    }
+    // Drop the middle frame from the log: frames start after the sender's
+    // idle gap
+    uint32_t frames = 1, cut_from = 0, cut_to = 0;
+    for (uint32_t i = 1; i < report_count; i++) {
+        if (reports[i].ms - reports[i - 1].ms >= LOCKFRAME_IDLE_MS) {
+            frames++;
+            if (frames == 2) cut_from = i;
+            if (frames == 3) cut_to = i;
+        }
+    }
+    CHECK(cut_from > 0 && cut_to > cut_from);
+    memmove(&reports[cut_from], &reports[cut_to], (report_count - cut_to) * sizeof(reports[0]));
+    report_count -= cut_to - cut_from;
+
+    receive();
+    CHECK_EQ(rx_frames, 2);
+    CHECK_EQ(lockframe_stats()->seq_gaps, 1);
+}
+
+TEST(corrupted_frame_is_rejected) {
+    const uint8_t dpi[] = { 0x20, 0x03 };
+    sender_begin(1);
+    CHECK(lockframe_send(LOCKFRAME_DPI, dpi, sizeof(dpi)));
+    sender_drain();
+
+    // Flip one data bit on a clock edge deep inside the payload
+    uint32_t edges = 0;
+    for (uint32_t i = 1; i < report_count; i++) {
+        if ((reports[i].leds ^ reports[i - 1].leds) & LOCKFRAME_CLOCK) {
+            if (++edges == 12) {
+                reports[i].leds ^= 0b001;
+                break;
+            }
+        }
+    }
+
+    receive();
+    CHECK_EQ(rx_frames, 0);
+    CHECK_EQ(lockframe_stats()->bad_checksum, 1);
+}
+
+TEST(held_111_is_still_a_sync_request) {
+    sender_begin(1);
+    lockstate_sync_request();
+    for (int i = 0; i < 2 * LOCKFRAME_IDLE_MS; i++) tick();
+
+    receive();
+    CHECK_EQ(rx_frames, 0);
+    CHECK_EQ(sync_requests, 1);
+}
+
+TEST(foreign_toggle_aborts_the_sender) {
+    const uint8_t dpi[] = { 0x20, 0x03 };
+    sender_begin(2);
+    CHECK(lockframe_send(LOCKFRAME_DPI, dpi, sizeof(dpi)));
+    for (int i = 0; i < 20; i++) tick();
+    shim_host_toggle(KC_CAPS_LOCK);
+    sender_drain();
+    CHECK_EQ(lockframe_stats()->sent, 0);
+    CHECK_EQ(lockframe_stats()->aborted, 1);
+
+    receive();
+    CHECK_EQ(rx_frames, 0);
+}
+
+int main(void) {
+    RUN(dpi_frame_round_trip);
+    RUN(frames_resume_the_fast_path_state);
+    RUN(sequence_numbers_count_gaps);
+    RUN(corrupted_frame_is_rejected);
+    RUN(held_111_is_still_a_sync_request);
+    RUN(foreign_toggle_aborts_the_sender);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,122 @@
+#include "test.h"
+#include "shared/lockstate/lockframe.h"
+#include <string.h>
+
+// The shared/lockstate receiver against the LED sequence a lib/ipc sender
+// produces: one lock per host report, Num then Caps then Scroll.
+
+#define TAP_MS 2
+
+static uint8_t rx_type, rx_len, rx_payload[LOCKFRAME_MAX_PAYLOAD];
+static int rx_frames, remote_changes, sync_requests;
+
+void lockframe_on_receive(uint8_t type, const uint8_t *payload, uint8_t len) {
+    rx_frames++;
+    rx_type = type;
+    rx_len = len;
+    memcpy(rx_payload, payload, len);
+}
+
+void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
+    (void)old_state; (void)new_state;
+    remote_changes++;
+}
+
+void lockstate_on_sync_request(void) {
+    sync_requests++;
+}
+
+static void run_ms(uint32_t ms) {
+    while (ms--) {
+        lockstate_task();
+        lockframe_task();
+        shim_advance_ms(1);
+    }
+}
+
+// The host toggles one lock; both keyboards get the LED report
+static void host_toggle(uint8_t bit) {
+    uint8_t leds = host_keyboard_led_state().raw ^ bit;
+    shim_set_led_state((led_t){ .raw = leds });
+    lockstate_led_update(leds);
+    run_ms(TAP_MS);
+}
+
+static void sender_write(uint8_t target) {
+    for (uint8_t bit = 0b001; bit <= 0b100; bit <<= 1) {
+        if ((host_keyboard_led_state().raw ^ target) & bit) host_toggle(bit);
+    }
+}
+
+static void send_frame(uint8_t seq, uint8_t type, const uint8_t *payload, uint8_t len) {
+    uint8_t frame[LOCKFRAME_MAX_PAYLOAD + LOCKFRAME_OVERHEAD];
+    frame[0] = (uint8_t)(seq << 4) | type;
+    frame[1] = len;
+    memcpy(&frame[2], payload, len);
+    frame[2 + len] = lockframe_crc8(frame, 2 + len);
+
+    uint8_t resume = host_keyboard_led_state().raw & 0b111;
+    sender_write(LOCK_STATE_SYNC_REQ);
+    for (uint8_t i = 0; i < (len + LOCKFRAME_OVERHEAD) * 4; i++) {
+        uint8_t data = (frame[i / 4] >> (6 - 2 * (i % 4))) & LOCKFRAME_DATA;
+        uint8_t clock = (host_keyboard_led_state().raw & LOCKFRAME_CLOCK) ^ LOCKFRAME_CLOCK;
+        sender_write(clock | data);
+    }
+    sender_write(LOCK_STATE_IDLE);
+    sender_write(resume);
+    run_ms(2 * LOCKFRAME_IDLE_MS);
+}
+
+static void begin(void) {
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    lockframe_init();
+    rx_frames = remote_changes = sync_requests = 0;
+    run_ms(10);
+    shim_tap_count = 0;
+}
+
+TEST(frame_is_received_without_side_effects) {
+    const uint8_t dpi[] = { 0x40, 0x06 };
+    begin();
+    send_frame(1, LOCKFRAME_DPI, dpi, sizeof(dpi));
+    CHECK_EQ(rx_frames, 1);
+    CHECK_EQ(rx_type, LOCKFRAME_DPI);
+    CHECK_EQ(rx_len, 2);
+    CHECK(memcmp(rx_payload, dpi, 2) == 0);
+    // Not a sync request, and the data symbols are not rewritten
+    CHECK_EQ(sync_requests, 0);
+    CHECK_EQ(remote_changes, 0);
+    CHECK_EQ(shim_tap_count, 0);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_IDLE);
+}
+
+TEST(frame_leaves_the_fast_path_state) {
+    const uint8_t count[] = { 1, 2, 3, 4 };
+    begin();
+    sender_write(LOCK_STATE_PA_SCROLL);
+    run_ms(LOCKSTATE_EVENT_SETTLE + 1);
+    CHECK_EQ(remote_changes, 1);
+
+    send_frame(1, LOCKFRAME_COUNTER, count, sizeof(count));
+    send_frame(3, LOCKFRAME_COUNTER, count, sizeof(count));
+    CHECK_EQ(rx_frames, 2);
+    CHECK_EQ(lockframe_stats()->seq_gaps, 1);
+    CHECK_EQ(remote_changes, 1);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_PA_SCROLL);
+    CHECK_EQ(shim_tap_count, 0);
+}
+
+TEST(held_111_is_still_a_sync_request) {
+    begin();
+    sender_write(LOCK_STATE_SYNC_REQ);
+    run_ms(LOCKFRAME_IDLE_MS + LOCKSTATE_EVENT_SETTLE + 2);
+    CHECK_EQ(rx_frames, 0);
+    CHECK_EQ(sync_requests, 1);
+}
+
+int main(void) {
+    RUN(frame_is_received_without_side_effects);
+    RUN(frame_leaves_the_fast_path_state);
+    RUN(held_111_is_still_a_sync_request);
+    return test_summary(__FILE__);
+}
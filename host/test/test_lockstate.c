@@ -0,0 +1,282 @@
+#include "test.h"
+#include "lib/ipc/lockstate.h"
+
+static int remote_changes;
+static lock_state_t last_remote;
+static int sync_requests;
+
+void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
+    (void)old_state;
+    remote_changes++;
+    last_remote = new_state;
+}
+
+void lockstate_on_sync_request(void) {
+    sync_requests++;
+}
+
+static void host_leds(uint8_t bits) {
+    led_t led = { .raw = 0 };
+    led.num_lock = bits & 0b001;
+    led.caps_lock = bits & 0b010;
+    led.scroll_lock = bits & 0b100;
+    shim_set_led_state(led);
+}
+
+static void poll(void) {
+    shim_advance_ms(LOCKSTATE_POLL_INTERVAL);
+    lockstate_task();
+}
+
+static void finish_write(void) {
+    for (int t = 0; t < 2 * LOCKSTATE_ECHO_LOST && lockstate_writing(); t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+}
+
+TEST(set_toggles_only_differing_locks) {
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    lockstate_set(LOCK_STATE_ML_MACRO);
+    finish_write();
+    CHECK_EQ(shim_tap_count, 2);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_MACRO);
+
+    lockstate_set(LOCK_STATE_ML_NUM);
+    finish_write();
+    CHECK_EQ(shim_tap_count, 3);
+    CHECK_EQ(shim_taps[2], KC_NUM_LOCK);
+}
+
+TEST(write_is_one_tap_per_echo) {
+    shim_led_delay_ms = 3;
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    lockstate_set(LOCK_STATE_PA_MEDIA);
+    CHECK_EQ(shim_tap_count, 1);
+    CHECK_EQ(shim_taps[0], KC_CAPS_LOCK);
+    CHECK(lockstate_writing());
+
+    // Nothing more until the host echoes caps lock
+    for (int t = 0; t < 2; t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+    CHECK_EQ(shim_tap_count, 1);
+    shim_advance_ms(1);
+    lockstate_task();
+    CHECK_EQ(shim_tap_count, 2);
+    CHECK_EQ(shim_taps[1], KC_SCROLL_LOCK);
+
+    finish_write();
+    CHECK(!lockstate_writing());
+    CHECK_EQ(lockstate_get(), LOCK_STATE_PA_MEDIA);
+    CHECK_EQ(lockstate.write_failures, 0);
+}
+
+TEST(half_applied_write_is_not_a_conflict) {
+    remote_changes = 0;
+    shim_led_delay_ms = 3;
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    lockstate_set(LOCK_STATE_PA_MEDIA);
+    // The caps echo alone reads as ML_NUM, a remote state; it must not be
+    // reported or rewritten
+    for (int t = 0; t < 5; t++) {
+        shim_advance_ms(1);
+        lockstate_led_update(lockstate_get());
+        lockstate_task();
+    }
+    finish_write();
+    for (int t = 0; t < LOCKSTATE_POLL_INTERVAL; t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+    CHECK_EQ(remote_changes, 0);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_PA_MEDIA);
+    CHECK_EQ(shim_tap_count, 2);
+}
+
+TEST(missing_echo_abandons_the_write) {
+    shim_led_echo = false;
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    lockstate_set(LOCK_STATE_ML_MACRO);
+    for (int t = 1; t < LOCKSTATE_ECHO_LOST; t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+    CHECK(lockstate_writing());
+    CHECK_EQ(shim_tap_count, 1);
+
+    shim_advance_ms(1);
+    lockstate_task();
+    CHECK_EQ(lockstate.write_failures, 1);
+}
+
+// An echo past LOCKSTATE_ECHO_TIMEOUT is waited for, never tapped again:
+// a second press would toggle the lock back once the first one lands
+TEST(slow_echo_is_not_tapped_twice) {
+    shim_led_delay_ms = 2 * LOCKSTATE_ECHO_TIMEOUT;
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    uint16_t failures = lockstate.write_failures, late = lockstate.write_late;
+    lockstate_set(LOCK_STATE_ML_MACRO);
+    finish_write();
+    CHECK(!lockstate_writing());
+    CHECK_EQ(shim_tap_count, 2);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_MACRO);
+    CHECK_EQ(lockstate.write_failures, failures);
+    CHECK_EQ(lockstate.write_late, late + 2);
+
+    // The peer's taps will be as far apart, so events wait longer to settle
+    CHECK(lockstate_settle_ms() > shim_led_delay_ms);
+}
+
+// tap_code() would hold Caps Lock for TAP_HOLD_CAPS_DELAY with the scan
+// stopped; the engine presses on one call and releases on the next
+TEST(caps_lock_write_never_blocks) {
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    uint32_t before = shim_ms(), reports = shim_report_count;
+    lockstate_set(LOCK_STATE_ML_NUM);
+    CHECK_EQ(shim_ms(), before);
+    CHECK_EQ(shim_taps[0], KC_CAPS_LOCK);
+    CHECK_EQ(shim_report_count, reports + 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_ML_NUM);
+    CHECK(lockstate_writing());
+
+    shim_advance_ms(1);
+    lockstate_task();
+    CHECK_EQ(shim_report_count, reports + 2);
+    CHECK(!lockstate_writing());
+}
+
+TEST(unowned_states_are_refused) {
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    lockstate_set(LOCK_STATE_ML_NAV);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_IDLE);
+    CHECK_EQ(shim_tap_count, 0);
+}
+
+TEST(remote_change_is_reported_on_poll) {
+    remote_changes = 0;
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    host_leds(LOCK_STATE_ML_NAV);
+
+    shim_advance_ms(LOCKSTATE_POLL_INTERVAL - 1);
+    lockstate_task();
+    CHECK_EQ(remote_changes, 0);
+    shim_advance_ms(1);
+    lockstate_task();
+    CHECK_EQ(remote_changes, 1);
+    CHECK_EQ(last_remote, LOCK_STATE_ML_NAV);
+    CHECK_EQ(lockstate_cached(), LOCK_STATE_ML_NAV);
+}
+
+TEST(sync_request_resets_to_idle) {
+    sync_requests = 0;
+    lockstate_init(LOCK_ROLE_PRIMARY);
+    host_leds(LOCK_STATE_SYNC_REQ);
+    poll();
+    finish_write();
+    CHECK_EQ(sync_requests, 1);
+    CHECK_EQ(lockstate_get(), LOCK_STATE_IDLE);
+}
+
+static void host_report(uint8_t bits) {
+    host_leds(bits);
+    lockstate_led_update(bits);
+}
+
+// Ms from a remote host LED change to lockstate_on_remote_change(), worst
+// case over every phase of the poll timer, with lockstate_task() at 1 kHz
+// like pointing_device_task_user()
+static uint32_t worst_latency(bool events) {
+    uint32_t worst = 0;
+    for (uint32_t phase = 0; phase < LOCKSTATE_POLL_INTERVAL; phase++) {
+        shim_reset();
+        remote_changes = 0;
+        lockstate_init(LOCK_ROLE_SECONDARY);
+        if (events) host_report(LOCK_STATE_IDLE);
+        for (uint32_t t = 0; t < LOCKSTATE_FALLBACK_INTERVAL + phase; t++) {
+            shim_advance_ms(1);
+            lockstate_task();
+        }
+
+        if (events) {
+            host_report(LOCK_STATE_ML_NAV);
+        } else {
+            host_leds(LOCK_STATE_ML_NAV);
+        }
+        uint32_t latency = 0;
+        while (remote_changes == 0 && latency < 10 * LOCKSTATE_FALLBACK_INTERVAL) {
+            shim_advance_ms(1);
+            lockstate_task();
+            latency++;
+        }
+        if (latency > worst) worst = latency;
+    }
+    return worst;
+}
+
+TEST(led_events_cut_worst_case_latency) {
+    uint32_t polled = worst_latency(false);
+    uint32_t evented = worst_latency(true);
+    printf("  remote change latency: polled %ums, event-driven %ums (worst case)\n",
+           polled, evented);
+    CHECK_EQ(polled, LOCKSTATE_POLL_INTERVAL);
+    CHECK_EQ(evented, LOCKSTATE_EVENT_SETTLE);
+}
+
+TEST(intermediate_states_are_skipped) {
+    remote_changes = 0;
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    host_report(LOCK_STATE_ML_NAV);
+    shim_advance_ms(LOCKSTATE_EVENT_SETTLE);
+    lockstate_task();
+    CHECK_EQ(remote_changes, 1);
+
+    // NAV -> NUM echoes num lock first, passing through IDLE
+    host_report(LOCK_STATE_IDLE);
+    shim_advance_ms(2);
+    lockstate_task();
+    host_report(LOCK_STATE_ML_NUM);
+    for (int t = 0; t < LOCKSTATE_EVENT_SETTLE; t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+    CHECK_EQ(remote_changes, 2);
+    CHECK_EQ(last_remote, LOCK_STATE_ML_NUM);
+}
+
+TEST(polling_remains_as_fallback) {
+    remote_changes = 0;
+    lockstate_init(LOCK_ROLE_SECONDARY);
+    host_report(LOCK_STATE_IDLE);
+    shim_advance_ms(LOCKSTATE_EVENT_SETTLE);
+    lockstate_task();
+
+    // A report that never reached led_update_user()
+    host_leds(LOCK_STATE_ML_MACRO);
+    for (int t = 0; t < LOCKSTATE_POLL_INTERVAL; t++) {
+        shim_advance_ms(1);
+        lockstate_task();
+    }
+    CHECK_EQ(remote_changes, 0);
+    shim_advance_ms(LOCKSTATE_FALLBACK_INTERVAL);
+    lockstate_task();
+    CHECK_EQ(remote_changes, 1);
+    CHECK_EQ(last_remote, LOCK_STATE_ML_MACRO);
+}
+
+int main(void) {
+    RUN(set_toggles_only_differing_locks);
+    RUN(write_is_one_tap_per_echo);
+    RUN(half_applied_write_is_not_a_conflict);
+    RUN(missing_echo_abandons_the_write);
+    RUN(slow_echo_is_not_tapped_twice);
+    RUN(caps_lock_write_never_blocks);
+    RUN(unowned_states_are_refused);
+    RUN(remote_change_is_reported_on_poll);
+    RUN(sync_request_resets_to_idle);
+    RUN(led_events_cut_worst_case_latency);
+    RUN(intermediate_states_are_skipped);
+    RUN(polling_remains_as_fallback);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,81 @@
+#include "test.h"
+#include <string.h>
+#include "util/logger.h"
+
+// The Makefile builds this with a 16-word ring: 15 usable, as one slot
+// stays empty, so five one-argument records (three words each) fill it
+#define RECORDS_THAT_FIT 5
+
+static char expected[1024];
+static size_t expected_len;
+
+static void expect(const char *line, uint32_t time, int n) {
+    expected_len += snprintf(expected + expected_len, sizeof(expected) - expected_len,
+                             "%8lu [INF] %s=%d\n", (unsigned long)time, line, n);
+}
+
+static void drain(void) {
+    for (uint8_t i = 0; i < 2 * LOG_DEFERRED_WORDS; i++) {
+        log_task();
+    }
+}
+
+TEST(records_wait_for_idle) {
+    log_set_level(LOG_LEVEL_INFO);
+    expected_len = 0;
+
+    shim_set_activity(0);
+    LOG_INFO("n=%d", -7);
+    LOG_DEBUG("hidden=%d", 1);
+    log_task();
+    CHECK_STR(shim_console(), "");
+
+    shim_advance_ms(LOG_DEFERRED_IDLE_MS);
+    drain();
+    expect("n", SHIM_BOOT_MS, -7);
+    CHECK_STR(shim_console(), expected);
+}
+
+TEST(full_ring_drops_and_counts) {
+    log_set_level(LOG_LEVEL_INFO);
+    expected_len = 0;
+
+    shim_set_activity(0);
+    for (int i = 0; i < RECORDS_THAT_FIT + 3; i++) {
+        LOG_INFO("n=%d", i);
+    }
+    shim_advance_ms(LOG_DEFERRED_IDLE_MS);
+
+    // The drop count comes first, then the kept records in order,
+    // LOG_DEFERRED_FLUSH_PER_SCAN of them per call
+    log_task();
+    expected_len = snprintf(expected, sizeof(expected), "[WRN] Log buffer full - dropped 3 records\n");
+    for (int i = 0; i < LOG_DEFERRED_FLUSH_PER_SCAN; i++) {
+        expect("n", SHIM_BOOT_MS, i);
+    }
+    CHECK_STR(shim_console(), expected);
+
+    drain();
+    for (int i = LOG_DEFERRED_FLUSH_PER_SCAN; i < RECORDS_THAT_FIT; i++) {
+        expect("n", SHIM_BOOT_MS, i);
+    }
+    CHECK_STR(shim_console(), expected);
+
+    // Drained, the ring takes a full load again across the wrap, and the
+    // drop count was reset
+    shim_console_clear();
+    expected_len = 0;
+    uint32_t now = shim_ms();
+    for (int i = 0; i < RECORDS_THAT_FIT; i++) {
+        LOG_INFO("m=%d", i);
+        expect("m", now, i);
+    }
+    drain();
+    CHECK_STR(shim_console(), expected);
+}
+
+int main(void) {
+    RUN(records_wait_for_idle);
+    RUN(full_ring_drops_and_counts);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,57 @@
+#include "test.h"
+#include "lib/pointing/pipeline.h"
+
+static bool frozen, mode_a;
+static int order[8], order_len;
+
+static bool frozen_enabled(void) { return frozen; }
+static bool a_enabled(void) { return mode_a; }
+
+static bool frozen_stage(report_mouse_t *r) { order[order_len++] = 'f'; r->x = r->y = 0; return false; }
+static bool settle_stage(report_mouse_t *r) { (void)r; order[order_len++] = 's'; return true; }
+static bool a_stage(report_mouse_t *r) { order[order_len++] = 'a'; r->x *= 10; return true; }
+static bool cursor_stage(report_mouse_t *r) { order[order_len++] = 'c'; r->x += 1; return true; }
+static bool post_stage(report_mouse_t *r) { order[order_len++] = 'p'; r->v = 7; return true; }
+
+static const pipeline_stage_t stages[] = {
+    PIPELINE_STAGE("frozen", PIPELINE_FILTER,    frozen_enabled, frozen_stage),
+    PIPELINE_STAGE("settle", PIPELINE_TRANSFORM, NULL,           settle_stage),
+    PIPELINE_STAGE("a",      PIPELINE_CONSUME,   a_enabled,      a_stage),
+    PIPELINE_STAGE("cursor", PIPELINE_CONSUME,   NULL,           cursor_stage),
+    PIPELINE_STAGE("post",   PIPELINE_TRANSFORM, NULL,           post_stage),
+};
+
+static report_mouse_t run(int16_t x) {
+    report_mouse_t r = { .x = x };
+    order_len = 0;
+    return pipeline_run(stages, PIPELINE_LENGTH(stages), r);
+}
+
+TEST(first_enabled_consumer_wins) {
+    frozen = false;
+    mode_a = false;
+    report_mouse_t r = run(5);
+    CHECK_EQ(r.x, 6);
+    CHECK_EQ(order_len, 3);
+
+    mode_a = true;
+    r = run(5);
+    CHECK_EQ(r.x, 50);
+    CHECK_EQ(order[1], 'a');
+    CHECK_EQ(order[2], 'p');
+    CHECK_EQ(r.v, 7);
+}
+
+TEST(filter_ends_the_pass) {
+    frozen = true;
+    report_mouse_t r = run(5);
+    CHECK_EQ(r.x, 0);
+    CHECK_EQ(r.v, 0);
+    CHECK_EQ(order_len, 1);
+}
+
+int main(void) {
+    RUN(first_enabled_consumer_wins);
+    RUN(filter_ends_the_pass);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,184 @@
+#include "test.h"
+#include <string.h>
+#include "feature/rgb/compositor.h"
+#include "feature/rgb/indicators.h"
+#include "feature/rgb/confetti.h"
+#include "core/layers.h"
+
+TEST(solid_color_writes_only_covered_leds) {
+    compositor_init();
+    compositor_set(COMP_PARTICLES, 5, (RGB){ 255, 0, 0 }, COMP_ALPHA_OPAQUE);
+    compositor_render();
+
+    CHECK_EQ(shim_rgb_writes, 1);
+    CHECK_EQ(shim_leds[5].r, 255);
+    CHECK_EQ(shim_leds[5].g, 0);
+}
+
+TEST(base_leaves_the_user_hsv_alone) {
+    compositor_init();
+    compositor_set_base((HSV){ 0, 0, 40 });
+    compositor_render();
+
+    // The effect still shows the user's colour, so the base is painted here
+    CHECK_EQ(shim_rgb_hsv.s, 255);
+    CHECK_EQ(shim_rgb_hsv.v, 255);
+    CHECK_EQ(shim_rgb_writes, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(shim_leds[71].r, 40);
+
+    // Back on the user's colour, the effect paints the base again
+    compositor_set_base(shim_rgb_hsv);
+    shim_rgb_writes = 0;
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, 0);
+}
+
+TEST(overlays_blend_over_the_base) {
+    compositor_init();
+    compositor_set_base((HSV){ 0, 0, 0 });
+    compositor_set(COMP_LAYER_INDICATOR, 0, (RGB){ 200, 200, 200 }, 128);
+    compositor_render();
+    CHECK_EQ(shim_leds[0].r, 200 * 128 / 255);
+
+    // Higher layers go on top
+    compositor_set(COMP_PARTICLES, 0, (RGB){ 0, 0, 255 }, COMP_ALPHA_OPAQUE);
+    compositor_render();
+    CHECK_EQ(shim_leds[0].b, 255);
+    CHECK_EQ(shim_leds[0].r, 0);
+}
+
+TEST(cleared_layer_falls_back_to_the_effect) {
+    compositor_init();
+    compositor_set(COMP_PARTICLES, 9, (RGB){ 1, 2, 3 }, COMP_ALPHA_OPAQUE);
+    compositor_render();
+    compositor_clear_layer(COMP_PARTICLES);
+    shim_rgb_writes = 0;
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, 0);
+}
+
+TEST(other_modes_write_every_led) {
+    shim_rgb_mode = 7;
+    compositor_init();
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, RGB_MATRIX_LED_COUNT);
+}
+
+// The effect repaints every LED before the compositor runs; a black
+// repaint shows any LED the compositor left alone
+static void render_frame(void) {
+    memset(shim_leds, 0, sizeof(shim_leds));
+    compositor_render();
+}
+
+// The Makefile moves the Num Lock LED onto layer bit 0 (LED 0)
+TEST(indicators_blend_in_priority_order) {
+    compositor_init();
+    indicators_init();
+    compositor_set_base((HSV){ 0, 0, 0 });
+    RGB layer = hsv_to_rgb((HSV){ INDICATOR_LAYER_HUE, 255, INDICATOR_VAL });
+    RGB lock  = hsv_to_rgb((HSV){ INDICATOR_LOCK_HUE, 255, INDICATOR_VAL });
+
+    // _NUM = 0b010 lights only the second layer LED
+    layer_on(_NUM);
+    indicators_update();
+    render_frame();
+    CHECK_EQ(shim_leds[0].b, 0);
+    CHECK_EQ(shim_leds[5].b, layer.b);
+
+    // _MACRO = 0b100 with _NUM still on: the highest layer wins
+    layer_on(_MACRO);
+    indicators_update();
+    render_frame();
+    CHECK_EQ(shim_leds[5].b, 0);
+    CHECK_EQ(shim_leds[10].b, layer.b);
+
+    // _FUNC = 0b011 lights LED 0; Num Lock on the same LED goes over it
+    layer_off(_MACRO);
+    layer_on(_FUNC);
+    shim_set_led_state((led_t){ .num_lock = 1, .scroll_lock = 1 });
+    indicators_update();
+    render_frame();
+    CHECK_EQ(shim_leds[0].g, lock.g);
+    CHECK_EQ(shim_leds[0].b, lock.b);
+    CHECK_EQ(shim_leds[46].g, lock.g);
+    CHECK_EQ(shim_leds[41].g, 0);
+
+    // A particle goes over both indicators
+    compositor_set(COMP_PARTICLES, 0, (RGB){ 255, 0, 0 }, COMP_ALPHA_OPAQUE);
+    render_frame();
+    CHECK_EQ(shim_leds[0].r, 255);
+    CHECK_EQ(shim_leds[0].g, 0);
+
+    // Removing the top two layers uncovers the layer indicator
+    compositor_clear_layer(COMP_PARTICLES);
+    shim_set_led_state((led_t){ 0 });
+    indicators_update();
+    render_frame();
+    CHECK_EQ(shim_leds[0].b, layer.b);
+    CHECK_EQ(shim_leds[0].g, layer.g);
+    CHECK_EQ(shim_leds[46].g, 0);
+}
+
+TEST(indicators_skip_unchanged_state) {
+    compositor_init();
+    indicators_init();
+    layer_on(_NAV);
+    indicators_update();
+    compositor_render();
+
+    // Same layer and locks: nothing to re-blend or write beyond the overlay
+    shim_rgb_writes = 0;
+    indicators_update();
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, 1);
+
+    // The base layer and no locks cover nothing
+    layer_clear();
+    indicators_update();
+    shim_rgb_writes = 0;
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, 0);
+}
+
+static uint8_t lit_leds(void) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        n += shim_leds[i].r || shim_leds[i].g || shim_leds[i].b;
+    }
+    return n;
+}
+
+TEST(confetti_leaves_no_trail) {
+    compositor_init();
+    confetti_init();
+    confetti_trigger();
+
+    // Only the LEDs particles sit on this frame are lit; the burst darkens
+    // the base, so the effect repaints black
+    uint16_t frames = 0;
+    while (confetti_active() && frames < 1000) {
+        confetti_update();
+        render_frame();
+        CHECK(lit_leds() <= CONFETTI_PARTICLES);
+        frames++;
+    }
+    CHECK(!confetti_active());
+
+    // Every LED a particle left was cleared: nothing covers the base
+    shim_rgb_writes = 0;
+    compositor_render();
+    CHECK_EQ(shim_rgb_writes, 0);
+}
+
+int main(void) {
+    RUN(solid_color_writes_only_covered_leds);
+    RUN(base_leaves_the_user_hsv_alone);
+    RUN(overlays_blend_over_the_base);
+    RUN(cleared_layer_falls_back_to_the_effect);
+    RUN(other_modes_write_every_led);
+    RUN(indicators_blend_in_priority_order);
+    RUN(indicators_skip_unchanged_state);
+    RUN(confetti_leaves_no_trail);
+    return test_summary(__FILE__);
+}
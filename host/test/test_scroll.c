@@ -0,0 +1,104 @@
+#include "test.h"
+#include "lib/pointing/scroll.h"
+
+// Drive one pointing pass: motion in, wheel units out
+static void pass(scroll_state_t *s, int16_t dx, int16_t dy, int32_t *h, int32_t *v) {
+    int16_t sh, sv;
+    shim_advance_ms(1);
+    scroll_accumulate(s, dx, dy);
+    scroll_coast(s);
+    scroll_consume(s, &sh, &sv, HV_REPORT_MAX);
+    *h += sh;
+    *v += sv;
+}
+
+TEST(hires_units_per_detent) {
+    scroll_state_t s;
+    int32_t h = 0, v = 0;
+    scroll_init(&s, 256, 120);
+
+    // One count at unit sensitivity is one detent: 120 hi-res units
+    pass(&s, 1, -1, &h, &v);
+    CHECK_EQ(h, 120);
+    CHECK_EQ(v, 120);
+}
+
+TEST(remainders_are_kept) {
+    scroll_state_t s;
+    int32_t h = 0, v = 0;
+    scroll_init(&s, 230, 1);
+
+    // 0.9 detents per count: nothing reaches the report until a whole one
+    pass(&s, 0, -1, &h, &v);
+    CHECK_EQ(v, 0);
+    for (int i = 0; i < 9; i++) pass(&s, 0, -1, &h, &v);
+    CHECK_EQ(v, 230 * 10 / 256);
+}
+
+TEST(report_limit_carries_the_rest) {
+    scroll_state_t s;
+    int16_t sh, sv;
+    scroll_init(&s, 256, 120);
+
+    scroll_accumulate(&s, 2, 0);
+    scroll_consume(&s, &sh, &sv, 127);
+    CHECK_EQ(sh, 127);
+    scroll_consume(&s, &sh, &sv, 127);
+    CHECK_EQ(sh, 240 - 127);
+}
+
+TEST(flick_coasts_and_decays) {
+    scroll_state_t s;
+    int32_t h = 0, v = 0;
+    scroll_init(&s, SCROLL_SENSITIVITY_Q8, 120);
+
+    for (int i = 0; i < 30; i++) pass(&s, 0, -20, &h, &v);
+    int32_t dragged = v;
+    CHECK(dragged > 0);
+
+    // Ball stops: momentum starts after the idle time and dies out
+    int ms = 0;
+    while (ms < 5000) {
+        pass(&s, 0, 0, &h, &v);
+        ms++;
+        if (ms > SCROLL_KINETIC_IDLE_MS && !scroll_coasting(&s)) break;
+    }
+    CHECK(v > dragged);
+    CHECK(!scroll_coasting(&s));
+    CHECK(ms < 5000);
+}
+
+TEST(slow_drag_does_not_coast) {
+    scroll_state_t s;
+    int32_t h = 0, v = 0;
+    scroll_init(&s, SCROLL_SENSITIVITY_Q8, 120);
+
+    for (int i = 0; i < 30; i++) {
+        shim_advance_ms(9);
+        pass(&s, 0, -1, &h, &v);
+    }
+    scroll_release(&s);
+    CHECK(!scroll_coasting(&s));
+}
+
+TEST(motion_cancels_momentum) {
+    scroll_state_t s;
+    int32_t h = 0, v = 0;
+    scroll_init(&s, SCROLL_SENSITIVITY_Q8, 120);
+
+    for (int i = 0; i < 30; i++) pass(&s, 0, -20, &h, &v);
+    scroll_release(&s);
+    CHECK(scroll_coasting(&s));
+    pass(&s, 1, 0, &h, &v);
+    CHECK(!scroll_coasting(&s));
+}
+
+int main(void) {
+    RUN(hires_units_per_detent);
+    RUN(remainders_are_kept);
+    RUN(report_limit_carries_the_rest);
+    RUN(flick_coasts_and_decays);
+    RUN(slow_drag_does_not_coast);
+    RUN(motion_cancels_momentum);
+    return test_summary(__FILE__);
+}
@@ -0,0 +1,98 @@
+#include "test.h"
+#include "util/send_packed.h"
+#include "util/send_queue.h"
+#include "util/send_integer.h"
+
+static const char *const samples[] = {
+    "git status\n",
+    "Hello, World!",
+    "aaaa",
+    "abcdefghijklmnopqrstuvwxyz0123456789",
+    "The Quick Brown Fox: \"jumps\" over {the} lazy_dog?",
+};
+
+TEST(packed_text_matches_serial_text) {
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        char serial[256];
+        uint32_t serial_reports, packed_reports;
+
+        shim_reset();
+        send_string(samples[i]);
+        strcpy(serial, shim_typed());
+        serial_reports = shim_report_count;
+
+        shim_reset();
+        send_packed_string(samples[i]);
+        CHECK_STR(shim_typed(), serial);
+        CHECK_STR(shim_typed(), samples[i]);
+        packed_reports = shim_report_count;
+        CHECK(packed_reports <= serial_reports);
+        CHECK_EQ(shim_mods(), 0);
+    }
+}
+
+TEST(rising_runs_share_a_report) {
+    send_packed_string("abc");
+    CHECK_EQ(shim_report_count, 2);
+}
+
+TEST(nkro_widens_runs) {
+    keymap_config.nkro = true;
+    send_packed_string("abcdefghij");
+    CHECK_EQ(shim_report_count, 2);
+
+    shim_reset();
+    send_packed_string("abcdefghij");
+    CHECK_EQ(shim_report_count, 4);
+}
+
+TEST(queue_types_a_few_runs_per_scan) {
+    send_queue_push("zyxwvutsrq");
+    send_queue_task();
+    // The budget counts flushed runs; the run that overflowed it is
+    // flushed at the end of the scan as well
+    CHECK_EQ(strlen(shim_typed()), SEND_QUEUE_TAPS_PER_SCAN + 1);
+    while (send_queue_busy()) send_queue_task();
+    CHECK_STR(shim_typed(), "zyxwvutsrq");
+}
+
+TEST(queue_delay_uses_the_clock) {
+    send_queue_push("a" SS_DELAY(100) "b");
+    send_queue_task();
+    CHECK_STR(shim_typed(), "a");
+
+    shim_advance_ms(99);
+    send_queue_task();
+    CHECK_STR(shim_typed(), "a");
+    shim_advance_ms(1);
+    send_queue_task();
+    CHECK_STR(shim_typed(), "ab");
+    CHECK(!send_queue_busy());
+}
+
+TEST(queue_is_all_or_nothing) {
+    char big[SEND_QUEUE_SIZE + 1];
+    memset(big, 'a', SEND_QUEUE_SIZE);
+    big[SEND_QUEUE_SIZE] = '\0';
+    CHECK(!send_queue_push(big));
+    CHECK(!send_queue_busy());
+}
+
+TEST(integers) {
+    send_integer_as_keycodes(-305);
+    CHECK_STR(shim_typed(), "-305");
+    shim_reset();
+    send_integer_padded(7, 3);
+    CHECK_STR(shim_typed(), "007");
+}
+
+int main(void) {
+    RUN(packed_text_matches_serial_text);
+    RUN(rising_runs_share_a_report);
+    RUN(nkro_widens_runs);
+    RUN(queue_types_a_few_runs_per_scan);
+    RUN(queue_delay_uses_the_clock);
+    RUN(queue_is_all_or_nothing);
+    RUN(integers);
+    return test_summary(__FILE__);
+}
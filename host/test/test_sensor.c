@@ -0,0 +1,56 @@
+#include "test.h"
+#include "lib/pointing/sensor.h"
+
+TEST(repeated_requests_skip_the_bus) {
+    sensor_cpi_init(800);
+    CHECK_EQ(shim_cpi_writes, 1);
+
+    // The lockstate block restates IDLE on every 1 ms pass
+    for (int i = 0; i < 1000; i++) sensor_cpi_release();
+    CHECK_EQ(shim_cpi_writes, 1);
+    CHECK_EQ(sensor_cpi_avoided(), 1000);
+}
+
+TEST(override_and_release) {
+    sensor_cpi_init(800);
+    for (int i = 0; i < 10; i++) sensor_cpi_override(400);
+    CHECK_EQ(shim_cpi, 400);
+    CHECK(sensor_cpi_overridden());
+
+    // A DPI change under an override waits for the release
+    sensor_cpi_set_base(1600);
+    CHECK_EQ(shim_cpi, 400);
+    sensor_cpi_release();
+    CHECK_EQ(shim_cpi, 1600);
+    CHECK_EQ(sensor_cpi_writes(), 3);
+    CHECK_EQ(shim_cpi_writes, 3);
+}
+
+TEST(invalidate_forces_a_write) {
+    sensor_cpi_init(800);
+    sensor_cpi_invalidate();
+    sensor_cpi_release();
+    CHECK_EQ(shim_cpi_writes, 2);
+    CHECK_EQ(sensor_cpi_current(), 800);
+}
+
+// The v1 sync reset: a new base under the override, then a forced rewrite
+TEST(sync_reset_under_override_writes_once) {
+    sensor_cpi_init(800);
+    sensor_cpi_override(400);
+    CHECK_EQ(shim_cpi_writes, 2);
+
+    sensor_cpi_set_base(1200);
+    sensor_cpi_invalidate();
+    sensor_cpi_release();
+    CHECK_EQ(shim_cpi, 1200);
+    CHECK_EQ(shim_cpi_writes, 3);
+}
+
+int main(void) {
+    RUN(repeated_requests_skip_the_bus);
+    RUN(override_and_release);
+    RUN(invalidate_forces_a_write);
+    RUN(sync_reset_under_override_writes_once);
+    return test_summary(__FILE__);
+}
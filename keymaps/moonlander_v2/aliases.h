@@ -213,6 +213,12 @@
 
 #define CONFET  X_CONFETTI
 
+// ═══════════════════════════════════════════════════════════════════════════
+// DEBUG
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define TRDUMP  X_TRDUMP   // Dump trace buffer (needs TRACE_ENABLE)
+
 // ═══════════════════════════════════════════════════════════════════════════
 // MISC
 // ═══════════════════════════════════════════════════════════════════════════
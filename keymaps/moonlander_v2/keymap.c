@@ -23,11 +23,15 @@
 #endif
 
 #ifdef RGB_MATRIX_ENABLE
+#include "lib/feature/rgb/compositor.h"
+#include "lib/feature/rgb/indicators.h"
 #include "lib/feature/rgb/breathing.h"
 #include "lib/feature/rgb/confetti.h"
 #endif
 
 #include "lib/util/logger.h"
+#include "lib/util/send_queue.h"
+#include "lib/util/trace.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // KEYMAPS
@@ -110,7 +114,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         ___,  ___,  ___,  ___,  ___,  ___,  ___,           ___,  ___,  ___,  ___,  ___,  ___,  ___,
         ___,  ___,  ___,  ___,  ___,  ___,  ___,           ___,  ___,  ___,  ___,  ___,  ___,  ___,
         ___,  ___,  ___,  ___,  ___,  ___,  ___,           ___,  PLAY, PRV,  VDN,  VUP,  NXT,  ___,
-        ___,  ___,  ___,  ___,  ___,  ___,                       MUTE, ___,  ___,  ___,  ___,  ___,
+        ___,  TRDUMP, ___, ___, ___,  ___,                       MUTE, ___,  ___,  ___,  ___,  ___,
         ___,  ___,  ___,  ___,  ___,        ___,           ___,        ___,  ___,  ___,  ___,  ___,
                                 ___,  ___,  ___,           FROM, ___,  ___
     ),
@@ -127,19 +131,34 @@ void keyboard_post_init_user(void) {
     LOG_INFO("Moonlander initialized");
 #endif
 
+#ifdef LEADER_HASH_ENABLE
+    leader_sequences_init();
+#endif
+
 #ifdef RGB_MATRIX_ENABLE
+    compositor_init();
+    indicators_init();
     breathing_init();
     confetti_init();
 #endif
+
+    trace_init();
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
 // KEY PROCESSING
 // ═══════════════════════════════════════════════════════════════════════════
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+static bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
     LOG_KEY(keycode, record->event.pressed);
 
+#ifdef TRACE_ENABLE
+    if (keycode == X_TRDUMP && record->event.pressed) {
+        trace_dump();
+        return false;
+    }
+#endif
+
 #ifdef RGB_MATRIX_ENABLE
     // Handle confetti trigger
     if (keycode == X_CONFETTI && record->event.pressed) {
@@ -172,15 +191,37 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    TRACE_BEGIN(TRACE_PROCESS_RECORD, keycode);
+    bool result = process_record_keymap(keycode, record);
+    TRACE_END(TRACE_PROCESS_RECORD);
+    return result;
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // MATRIX SCAN
 // ═══════════════════════════════════════════════════════════════════════════
 
 void matrix_scan_user(void) {
+    TRACE_BEGIN(TRACE_MATRIX_SCAN, 0);
+
 #ifdef LEADER_HASH_ENABLE
     leader_hash_task();
 #endif
+
+    send_queue_task();
+    TRACE_END(TRACE_MATRIX_SCAN);
+
+    log_task();
+    trace_task();
+}
+
+#ifdef TRACE_ENABLE
+// Runs at the end of each keyboard task, after any HID reports were sent
+void housekeeping_task_user(void) {
+    TRACE_MARK(TRACE_REPORT, 0);
 }
+#endif
 
 // ═══════════════════════════════════════════════════════════════════════════
 // LEADER SEQUENCE HANDLER
@@ -200,12 +241,19 @@ void leader_hash_end_user(void) {
 
 #ifdef RGB_MATRIX_ENABLE
 bool rgb_matrix_indicators_user(void) {
-    // Confetti takes priority over breathing
+    TRACE_BEGIN(TRACE_RGB_INDICATORS, 0);
+
+    // Confetti owns the base colour while it runs
     if (confetti_active()) {
         confetti_update();
     } else {
         breathing_update();
     }
+    indicators_update();
+
+    compositor_render();
+
+    TRACE_END(TRACE_RGB_INDICATORS);
     return false;
 }
 #endif
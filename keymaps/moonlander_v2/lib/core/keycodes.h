@@ -41,6 +41,11 @@ enum custom_keycodes {
     // ═══════════════════════════════════════════════════════════════
     DMP,        // Dynamic macro play (context-aware)
 
+    // ═══════════════════════════════════════════════════════════════
+    // DEBUG (0x7E40 - 0x7E4F)
+    // ═══════════════════════════════════════════════════════════════
+    X_TRDUMP,   // Dump the trace buffer to the console
+
     // ═══════════════════════════════════════════════════════════════
     // END MARKER
     // ═══════════════════════════════════════════════════════════════
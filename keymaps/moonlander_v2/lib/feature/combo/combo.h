@@ -14,6 +14,7 @@
 
 #include "quantum.h"
 #include "../core/keycodes.h"
+#include "../../util/send_queue.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Macro Definitions for combos.def processing
@@ -35,10 +36,10 @@
 #define K_COMB(name, key, ...) [name] = COMBO(cmb_##name, key),
 #define A_COMB(name, string, ...) [name] = COMBO_ACTION(cmb_##name),
 
-// Generator macros for combo actions
+// Generator macros for combo actions (strings are typed by send_queue_task())
 #define A_ACTI(name, string, ...) \
     case name: \
-        if (pressed) SEND_STRING(string); \
+        if (pressed) SEND_STRING_QUEUED(string); \
         break;
 
 #define A_TOGG(name, layer, ...) \
@@ -15,6 +15,16 @@ static uint16_t leader_timer        = 0;
 static uint32_t leader_hash         = 0;
 static uint8_t  leader_index        = 0;
 
+// Registered sequence table (PROGMEM) and RAM index sorted by (hash, length)
+static const leader_seq_t *seq_table = NULL;
+static uint16_t seq_count           = 0;
+static uint16_t seq_order[LEADER_HASH_MAX_SEQUENCES];
+
+// RAM index sorted by key sequence, and the range matching the keys so far
+static uint16_t prefix_order[LEADER_HASH_MAX_SEQUENCES];
+static uint16_t prefix_lo           = 0;
+static uint16_t prefix_hi           = 0;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Weak Callbacks
 // ═══════════════════════════════════════════════════════════════════════════
@@ -37,7 +47,135 @@ __attribute__((weak)) void leader_hash_end_user(void) {
  */
 static uint32_t hash_combine(uint16_t keycode, uint8_t index, uint32_t current_hash) {
     // Rotate left by 5, then XOR with keycode
-    return ((current_hash << 5) | (current_hash >> 27)) ^ keycode;
+    return LEADER_HASH_STEP(current_hash, keycode);
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Sequence Index
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint32_t seq_hash_at(uint16_t i) {
+    return pgm_read_dword(&seq_table[seq_order[i]].hash);
+}
+
+static uint8_t seq_length_at(uint16_t i) {
+    return pgm_read_byte(&seq_table[seq_order[i]].length);
+}
+
+/**
+ * Orders entries by hash, then by length
+ * @return negative, zero or positive like memcmp
+ */
+static int8_t seq_compare(uint32_t hash_a, uint8_t len_a, uint32_t hash_b, uint8_t len_b) {
+    if (hash_a != hash_b) {
+        return hash_a < hash_b ? -1 : 1;
+    }
+    if (len_a != len_b) {
+        return len_a < len_b ? -1 : 1;
+    }
+    return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Prefix Index
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Sort key of a table entry at a given depth
+ * 0 when the sequence is already complete, so exact matches sort first
+ */
+static uint32_t prefix_key(uint16_t entry, uint8_t depth) {
+    if (pgm_read_byte(&seq_table[entry].length) <= depth) {
+        return 0;
+    }
+    return (uint32_t)pgm_read_word(&seq_table[entry].keys[depth]) + 1;
+}
+
+static int8_t prefix_compare(uint16_t a, uint16_t b) {
+    for (uint8_t depth = 0; depth < LEADER_HASH_MAX_LENGTH; depth++) {
+        uint32_t key_a = prefix_key(a, depth);
+        uint32_t key_b = prefix_key(b, depth);
+        if (key_a != key_b) {
+            return key_a < key_b ? -1 : 1;
+        }
+        if (key_a == 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+#ifdef LOGGING_ENABLE
+/**
+ * Log every sequence that is a strict prefix of another
+ * Entries extending a prefix sort directly after it in prefix_order
+ */
+static void prefix_report(void) {
+    uint16_t overlaps = 0;
+
+    for (uint16_t i = 0; i < seq_count; i++) {
+        uint16_t short_seq = prefix_order[i];
+        uint8_t  short_len = pgm_read_byte(&seq_table[short_seq].length);
+
+        for (uint16_t j = i + 1; j < seq_count; j++) {
+            uint16_t long_seq = prefix_order[j];
+            uint8_t  depth    = 0;
+            while (depth < short_len && prefix_key(short_seq, depth) == prefix_key(long_seq, depth)) {
+                depth++;
+            }
+            if (depth < short_len || pgm_read_byte(&seq_table[long_seq].length) == short_len) {
+                break;
+            }
+            LOG_WARN("Leader: %s is a prefix of %s (ends on timeout)",
+                     (const char *)pgm_read_ptr(&seq_table[short_seq].name),
+                     (const char *)pgm_read_ptr(&seq_table[long_seq].name));
+            overlaps++;
+        }
+    }
+
+    LOG_INFO("Leader: %u sequences, %u prefix overlaps", seq_count, overlaps);
+}
+#endif
+
+/**
+ * Binary search within [lo, hi) for the first entry whose key at depth is
+ * >= key (or > key when upper is set)
+ */
+static uint16_t prefix_bound(uint16_t lo, uint16_t hi, uint8_t depth, uint32_t key, bool upper) {
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        uint32_t k   = prefix_key(prefix_order[mid], depth);
+        if (k < key || (upper && k == key)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Narrow the matching range by one key and end the sequence early
+ * when the outcome can no longer change
+ */
+static void prefix_step(uint16_t keycode, uint8_t depth) {
+    uint32_t key = (uint32_t)keycode + 1;
+
+    prefix_lo = prefix_bound(prefix_lo, prefix_hi, depth, key, false);
+    prefix_hi = prefix_bound(prefix_lo, prefix_hi, depth, key, true);
+
+    if (prefix_lo == prefix_hi) {
+        LOG_DEBUG("Leader: no sequence matches - ending early");
+        leader_hash_end();
+        return;
+    }
+
+    // Entries sharing a prefix sort shortest first, so if the last one is
+    // complete, no longer sequence remains and the match is unique
+    if (pgm_read_byte(&seq_table[prefix_order[prefix_hi - 1]].length) == depth + 1) {
+        LOG_DEBUG("Leader: unique match - ending early");
+        leader_hash_end();
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -53,6 +191,8 @@ void leader_hash_start(void) {
     leader_timer  = timer_read();
     leader_hash   = 0;
     leader_index  = 0;
+    prefix_lo     = 0;
+    prefix_hi     = seq_count;
     
     leader_hash_start_user();
 }
@@ -79,6 +219,10 @@ bool leader_hash_add(uint16_t keycode) {
     
     LOG_TRACE("Leader add: 0x%04X -> hash: 0x%08lX (len: %d)", 
               keycode, leader_hash, leader_index);
+
+    if (seq_table != NULL) {
+        prefix_step(keycode, leader_index - 1);
+    }
     
     return true;
 }
@@ -132,6 +276,61 @@ uint32_t leader_hash_generate(const uint16_t keycodes[], uint8_t size) {
     return hash;
 }
 
+void leader_hash_register(const leader_seq_t *table, uint16_t count) {
+    if (count > LEADER_HASH_MAX_SEQUENCES) {
+        LOG_ERROR("Leader: %u sequences exceed LEADER_HASH_MAX_SEQUENCES", count);
+        count = LEADER_HASH_MAX_SEQUENCES;
+    }
+
+    seq_table = table;
+    seq_count = count;
+
+    // Insertion sort of the index - runs once at init, table is already in flash
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t hash = pgm_read_dword(&table[i].hash);
+        uint8_t  len  = pgm_read_byte(&table[i].length);
+        uint16_t j    = i;
+        while (j > 0 && seq_compare(hash, len, seq_hash_at(j - 1), seq_length_at(j - 1)) < 0) {
+            seq_order[j] = seq_order[j - 1];
+            j--;
+        }
+        seq_order[j] = i;
+    }
+
+    // Same again in key order for the prefix walk in leader_hash_add()
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t j = i;
+        while (j > 0 && prefix_compare(i, prefix_order[j - 1]) < 0) {
+            prefix_order[j] = prefix_order[j - 1];
+            j--;
+        }
+        prefix_order[j] = i;
+    }
+
+#ifdef LOGGING_ENABLE
+    prefix_report();
+#endif
+}
+
+const leader_seq_t *leader_hash_lookup(void) {
+    uint16_t lo = 0;
+    uint16_t hi = seq_count;
+
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        int8_t   cmp = seq_compare(leader_hash, leader_index, seq_hash_at(mid), seq_length_at(mid));
+        if (cmp == 0) {
+            return &seq_table[seq_order[mid]];
+        }
+        if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return NULL;
+}
+
 bool leader_hash_is(const uint16_t keycodes[], uint8_t size) {
     if (leader_index != size) {
         return false;
@@ -5,6 +5,15 @@
  * This implementation uses a rolling hash to detect leader sequences
  * without storing the full key history. Sequences are defined in
  * sequences.def using a human-readable SEQ() macro.
+ *
+ * Each sequence's hash is computed at compile time (LEADER_HASH_STEP) and
+ * stored in a PROGMEM table. The table is registered once at init, sorted
+ * by hash, and looked up with a binary search when a sequence ends.
+ *
+ * The same table is also indexed in key order and walked like a prefix
+ * trie as keys arrive: the sequence ends as soon as the typed keys match
+ * exactly one sequence, or nothing at all. LEADER_HASH_TIMEOUT only
+ * applies while the prefix is still ambiguous.
  */
 
 #ifndef LEADER_HASH_H
@@ -24,6 +33,38 @@
 // If defined, timeout only starts after first key in sequence
 #endif
 
+#ifndef LEADER_HASH_MAX_SEQUENCES
+#define LEADER_HASH_MAX_SEQUENCES 64  // Capacity of the sorted lookup index
+#endif
+
+#ifndef LEADER_HASH_MAX_LENGTH
+#define LEADER_HASH_MAX_LENGTH 5      // Longest sequence sequences.h can hash
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Sequence Table
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * One step of the rolling hash, usable in constant expressions
+ * Rotate left by 5, then XOR with keycode (shared with leader_hash.c)
+ */
+#define LEADER_HASH_STEP(hash, keycode) \
+    ((((uint32_t)(hash) << 5) | ((uint32_t)(hash) >> 27)) ^ (uint16_t)(keycode))
+
+/**
+ * Sequence table entry (stored in PROGMEM, generated by sequences.h)
+ */
+typedef struct {
+    uint32_t    hash;    // Compile-time hash of the key sequence
+    uint8_t     length;  // Number of keys in the sequence
+    const char *action;  // PROGMEM string for send_queue_push_P()
+    uint16_t    keys[LEADER_HASH_MAX_LENGTH];  // Keys, for prefix matching
+#ifdef LOGGING_ENABLE
+    const char *name;    // SEQ() name, for the prefix overlap report
+#endif
+} leader_seq_t;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Public API
 // ═══════════════════════════════════════════════════════════════════════════
@@ -42,6 +83,8 @@ bool leader_hash_active(void);
 
 /**
  * Add a keycode to the current sequence
+ * Ends the sequence immediately once the keys so far match exactly one
+ * registered sequence, or cannot match any
  * @param keycode The key that was pressed
  * @return true if key was consumed by leader system
  */
@@ -90,6 +133,23 @@ uint32_t leader_hash_generate(const uint16_t keycodes[], uint8_t size);
  */
 bool leader_hash_is(const uint16_t keycodes[], uint8_t size);
 
+/**
+ * Register the sequence table and build the sorted lookup index
+ * Call once from keyboard_post_init_user() (see leader_sequences_init())
+ * With LOGGING_ENABLE, also logs every sequence that is a prefix of a
+ * longer one (those can only end on timeout)
+ * @param table PROGMEM array of sequences
+ * @param count Number of entries (at most LEADER_HASH_MAX_SEQUENCES)
+ */
+void leader_hash_register(const leader_seq_t *table, uint16_t count);
+
+/**
+ * Find the registered sequence matching the current hash and length
+ * Binary search over the sorted index - cost does not depend on keycodes
+ * @return PROGMEM pointer to the entry, or NULL if nothing matches
+ */
+const leader_seq_t *leader_hash_lookup(void);
+
 /**
  * Get current hash value (for debugging)
  */
@@ -3,8 +3,14 @@
  * @brief Preprocessor for human-readable leader sequences
  *
  * This file processes sequences.def and generates:
- * 1. Compile-time hash values for each sequence
- * 2. Switch cases for leader_hash_end_user()
+ * 1. Compile-time checks: sequence length, hash collisions
+ * 2. A PROGMEM action string for each sequence
+ * 3. A PROGMEM table of compile-time hashes (leader_sequences[])
+ * 4. leader_sequences_init() / process_leader_sequences() helpers
+ *
+ * Dispatch is a binary search over the registered table, so the cost of
+ * process_leader_sequences() stays flat as sequences.def grows. The key
+ * arrays in the table also drive the early-ending prefix walk.
  *
  * Include this file in your keymap.c after defining aliases.
  */
@@ -13,6 +19,7 @@
 #define SEQUENCES_H
 
 #include "leader_hash.h"
+#include "../../util/send_queue.h"
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Hash Generation Macros
@@ -22,52 +29,127 @@
 #define SEQ_COUNT_ARGS(...) SEQ_COUNT_ARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
 #define SEQ_COUNT_ARGS_(_1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
 
-// Generate hash check case for each sequence
-#define SEQ_CASE_2(name, action, k1, k2) \
-    { static const uint16_t seq_##name[] = {k1, k2}; \
-      if (leader_hash_is(seq_##name, 2)) { SEND_STRING(action); return; } }
+// Compile-time hash for each sequence length (mirrors leader_hash_generate)
+#define SEQ_HASH_2(k1, k2) \
+    LEADER_HASH_STEP(LEADER_HASH_STEP(0, k1), k2)
 
-#define SEQ_CASE_3(name, action, k1, k2, k3) \
-    { static const uint16_t seq_##name[] = {k1, k2, k3}; \
-      if (leader_hash_is(seq_##name, 3)) { SEND_STRING(action); return; } }
+#define SEQ_HASH_3(k1, k2, k3) \
+    LEADER_HASH_STEP(SEQ_HASH_2(k1, k2), k3)
 
-#define SEQ_CASE_4(name, action, k1, k2, k3, k4) \
-    { static const uint16_t seq_##name[] = {k1, k2, k3, k4}; \
-      if (leader_hash_is(seq_##name, 4)) { SEND_STRING(action); return; } }
+#define SEQ_HASH_4(k1, k2, k3, k4) \
+    LEADER_HASH_STEP(SEQ_HASH_3(k1, k2, k3), k4)
 
-#define SEQ_CASE_5(name, action, k1, k2, k3, k4, k5) \
-    { static const uint16_t seq_##name[] = {k1, k2, k3, k4, k5}; \
-      if (leader_hash_is(seq_##name, 5)) { SEND_STRING(action); return; } }
+#define SEQ_HASH_5(k1, k2, k3, k4, k5) \
+    LEADER_HASH_STEP(SEQ_HASH_4(k1, k2, k3, k4), k5)
 
 // Helper to force expansion before token pasting
 #define SEQ_CAT(a, b) SEQ_CAT_(a, b)
 #define SEQ_CAT_(a, b) a##b
 
-// Dispatch to appropriate case generator based on arg count
-#define SEQ_DISPATCH(name, action, ...) \
-    SEQ_CAT(SEQ_CASE_, SEQ_COUNT_ARGS(__VA_ARGS__))(name, action, __VA_ARGS__)
+// Dispatch to appropriate hash generator based on arg count
+#define SEQ_HASH(...) \
+    SEQ_CAT(SEQ_HASH_, SEQ_COUNT_ARGS(__VA_ARGS__))(__VA_ARGS__)
+
+// Lookup identity of a sequence: length in the high word, hash in the low
+#define SEQ_ID(...) \
+    (((uint64_t)SEQ_COUNT_ARGS(__VA_ARGS__) << 32) | SEQ_HASH(__VA_ARGS__))
+
+#ifdef LOGGING_ENABLE
+#define SEQ_NAME(id) .name = #id,
+#else
+#define SEQ_NAME(id)
+#endif
+
+// Generator macros for each pass over sequences.def
+#define SEQ_CHECK(name, action, ...) \
+    _Static_assert(SEQ_COUNT_ARGS(__VA_ARGS__) >= 2 && \
+                   SEQ_COUNT_ARGS(__VA_ARGS__) <= LEADER_HASH_MAX_LENGTH, \
+                   "SEQ(" #name ") must have between 2 and LEADER_HASH_MAX_LENGTH keys");
+
+#define SEQ_CASE(name, action, ...) \
+    case SEQ_ID(__VA_ARGS__): break;
+
+#define SEQ_STRING(name, action, ...) \
+    static const char seq_str_##name[] PROGMEM = action;
+
+#define SEQ_ENTRY(id, str, ...) \
+    { .hash   = SEQ_HASH(__VA_ARGS__), \
+      .length = SEQ_COUNT_ARGS(__VA_ARGS__), \
+      .action = seq_str_##id, \
+      .keys   = { __VA_ARGS__ }, \
+      SEQ_NAME(id) },
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Compile-time checks
+// ═══════════════════════════════════════════════════════════════════════════
+#undef SEQ
+#define SEQ SEQ_CHECK
+
+#include "sequences.def"
+
+// Two sequences with the same length and hash would be indistinguishable
+// at lookup. A single X-macro pass cannot compare entries pairwise with
+// _Static_assert, so every SEQ_ID becomes a case label instead: a collision
+// (or a duplicated key sequence) fails the build with "duplicate case value"
+// pointing at the offending SEQ() line.
+#undef SEQ
+#define SEQ SEQ_CASE
+
+static inline void leader_sequences_check_collisions(uint64_t id) {
+    switch (id) {
+#include "sequences.def"
+        default:
+            break;
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Generate action strings
+// ═══════════════════════════════════════════════════════════════════════════
+#undef SEQ
+#define SEQ SEQ_STRING
 
-// Main SEQ macro
-#define SEQ(name, action, ...) SEQ_DISPATCH(name, action, __VA_ARGS__)
+#include "sequences.def"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Generate sequence table
+// ═══════════════════════════════════════════════════════════════════════════
+#undef SEQ
+#define SEQ SEQ_ENTRY
+
+static const leader_seq_t PROGMEM leader_sequences[] = {
+#include "sequences.def"
+};
+
+#define LEADER_SEQUENCE_COUNT (sizeof(leader_sequences) / sizeof(leader_sequences[0]))
+
+_Static_assert(LEADER_SEQUENCE_COUNT <= LEADER_HASH_MAX_SEQUENCES,
+               "Too many leader sequences - raise LEADER_HASH_MAX_SEQUENCES");
+
+#undef SEQ
 
 // ═══════════════════════════════════════════════════════════════════════════
 // User Implementation
 // ═══════════════════════════════════════════════════════════════════════════
 
+/**
+ * Register the generated table with the leader system
+ * Call this from keyboard_post_init_user()
+ */
+static inline void leader_sequences_init(void) {
+    leader_hash_register(leader_sequences, LEADER_SEQUENCE_COUNT);
+}
+
 /**
  * Process leader sequences
- * Call this from leader_hash_end_user() or include the inline version
+ * Call this from leader_hash_end_user()
+ * The action is queued and typed from matrix_scan_user() via send_queue_task()
  */
 static inline void process_leader_sequences(void) {
-    // Redefine SEQ for case generation
-    #undef SEQ
-    #define SEQ(name, action, ...) SEQ_DISPATCH(name, action, __VA_ARGS__)
-
-    // Include all sequence definitions
-    #include "sequences.def"
-
-    // Restore SEQ macro
-    #undef SEQ
+    const leader_seq_t *seq = leader_hash_lookup();
+    if (seq) {
+        send_queue_push_P((const char *)pgm_read_ptr(&seq->action));
+    }
 }
 
 #endif // SEQUENCES_H
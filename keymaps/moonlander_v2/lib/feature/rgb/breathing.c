@@ -4,24 +4,76 @@
  */
 
 #include "breathing.h"
+#include "compositor.h"
 
 #ifdef RGB_MATRIX_ENABLE
 
-#include <math.h>
+// ═══════════════════════════════════════════════════════════════════════════
+// Sine Table
+// ═══════════════════════════════════════════════════════════════════════════
+
+// One quarter of a sine wave: round(255 * sin(i / 256 * pi / 2))
+// The other three quarters are mirrored from it in breathing_sine(); entry
+// 256 is the peak, so a quarter is exactly 256 phase steps
+static const uint8_t PROGMEM quarter_sine[257] = {
+      0,   2,   3,   5,   6,   8,   9,  11,  13,  14,  16,  17,  19,  20,  22,  23,
+     25,  27,  28,  30,  31,  33,  34,  36,  37,  39,  41,  42,  44,  45,  47,  48,
+     50,  51,  53,  54,  56,  57,  59,  60,  62,  63,  65,  67,  68,  70,  71,  73,
+     74,  76,  77,  79,  80,  81,  83,  84,  86,  87,  89,  90,  92,  93,  95,  96,
+     98,  99, 100, 102, 103, 105, 106, 108, 109, 110, 112, 113, 115, 116, 117, 119,
+    120, 122, 123, 124, 126, 127, 128, 130, 131, 132, 134, 135, 136, 138, 139, 140,
+    142, 143, 144, 146, 147, 148, 149, 151, 152, 153, 154, 156, 157, 158, 159, 161,
+    162, 163, 164, 165, 167, 168, 169, 170, 171, 172, 174, 175, 176, 177, 178, 179,
+    180, 181, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195, 196,
+    197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208, 208, 209, 210, 211,
+    212, 213, 214, 215, 215, 216, 217, 218, 219, 220, 220, 221, 222, 223, 223, 224,
+    225, 226, 226, 227, 228, 228, 229, 230, 231, 231, 232, 232, 233, 234, 234, 235,
+    236, 236, 237, 237, 238, 238, 239, 240, 240, 241, 241, 242, 242, 243, 243, 244,
+    244, 244, 245, 245, 246, 246, 247, 247, 247, 248, 248, 248, 249, 249, 249, 250,
+    250, 250, 251, 251, 251, 252, 252, 252, 252, 252, 253, 253, 253, 253, 253, 254,
+    254, 254, 254, 254, 254, 254, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255,
+};
+
+#define PHASE_BITS  10                   // Phase steps per cycle = 1024
+#define PHASE_STEPS (1UL << PHASE_BITS)
+
+_Static_assert((uint64_t)BREATHING_PERIOD_MS * PHASE_STEPS <= UINT32_MAX,
+               "BREATHING_PERIOD_MS too long for 32-bit phase math");
 
 // ═══════════════════════════════════════════════════════════════════════════
 // Internal State
 // ═══════════════════════════════════════════════════════════════════════════
 
-static uint16_t breathing_timer = 0;
+static uint32_t breathing_timer = 0;
 static bool breathing_initialized = false;
 
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal Helpers
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Full-wave sine from the quarter table
+ * @param phase 0 to PHASE_STEPS - 1
+ * @return -255 to 255
+ */
+static int16_t breathing_sine(uint16_t phase) {
+    uint16_t index = phase & 0xFF;
+
+    switch (phase >> 8) {
+        case 0:  return  pgm_read_byte(&quarter_sine[index]);
+        case 1:  return  pgm_read_byte(&quarter_sine[256 - index]);
+        case 2:  return -pgm_read_byte(&quarter_sine[index]);
+        default: return -pgm_read_byte(&quarter_sine[256 - index]);
+    }
+}
+
 // ═══════════════════════════════════════════════════════════════════════════
 // Implementation
 // ═══════════════════════════════════════════════════════════════════════════
 
 void breathing_init(void) {
-    breathing_timer = timer_read();
+    breathing_timer = timer_read32();
     breathing_initialized = true;
 }
 
@@ -29,44 +81,30 @@ uint8_t breathing_get_val(void) {
     if (!breathing_initialized) {
         return BREATHING_MAX_VAL;
     }
-    
-    // Calculate position in breathing cycle (0.0 to 1.0)
-    uint16_t elapsed = timer_elapsed(breathing_timer) % BREATHING_PERIOD_MS;
-    float phase = (float)elapsed / (float)BREATHING_PERIOD_MS;
-    
-    // Use sine wave for smooth breathing (0 to 2π)
-    // sin returns -1 to 1, we need 0 to 1
-    float sine_val = (sinf(phase * 2.0f * 3.14159f) + 1.0f) / 2.0f;
-    
-    // Map to brightness range
-    uint8_t range = BREATHING_MAX_VAL - BREATHING_MIN_VAL;
-    return BREATHING_MIN_VAL + (uint8_t)(sine_val * range);
+
+    // Position in the breathing cycle (32-bit so the period never wraps early)
+    uint32_t elapsed = timer_elapsed32(breathing_timer) % BREATHING_PERIOD_MS;
+    uint16_t phase   = (elapsed * PHASE_STEPS) / BREATHING_PERIOD_MS;
+
+    // Shift the sine from -255..255 to 0..510, then map to brightness range
+    uint16_t level = breathing_sine(phase) + 255;
+    uint8_t  range = BREATHING_MAX_VAL - BREATHING_MIN_VAL;
+    return BREATHING_MIN_VAL + (uint8_t)(((uint32_t)level * range) / 510);
 }
 
 void breathing_update(void) {
     if (!breathing_initialized) {
         breathing_init();
     }
-    
-    // Get current breathing value
-    uint8_t val = breathing_get_val();
-    
-    // Create HSV color
+
     HSV hsv = {
         .h = BREATHING_HUE,
         .s = BREATHING_SAT,
-        .v = val
+        .v = breathing_get_val()
     };
-    
-    // Convert to RGB
-    RGB rgb = hsv_to_rgb(hsv);
-    
-    // Apply to all keys
-    // Note: This should be called from rgb_matrix_indicators_user()
-    // which handles the actual LED updates
-    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
-        rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
-    }
+
+    // The compositor ignores unchanged colours, so most frames stop here
+    compositor_set_base(hsv);
 }
 
 #endif // RGB_MATRIX_ENABLE
@@ -50,7 +50,8 @@ void breathing_init(void);
 
 /**
  * Update breathing effect
- * Call from rgb_matrix_indicators_user() or similar
+ * Sets the compositor base colour; call from rgb_matrix_indicators_user()
+ * before compositor_render()
  */
 void breathing_update(void);
 
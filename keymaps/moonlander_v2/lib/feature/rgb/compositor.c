@@ -0,0 +1,168 @@
+/**
+ * @file compositor.c
+ * @brief Layered RGB compositor implementation
+ */
+
+#include "compositor.h"
+
+#ifdef RGB_MATRIX_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define OVERLAY_COUNT (COMP_LAYER_COUNT - 1)
+#define BITMAP_BYTES  ((RGB_MATRIX_LED_COUNT + 7) / 8)
+
+typedef struct {
+    RGB     rgb;
+    uint8_t alpha;      // 0 = transparent
+} comp_pixel_t;
+
+static comp_pixel_t overlays[OVERLAY_COUNT][RGB_MATRIX_LED_COUNT];
+static RGB          composed[RGB_MATRIX_LED_COUNT];
+
+static uint8_t dirty[BITMAP_BYTES];     // LED needs re-blending
+static uint8_t covered[BITMAP_BYTES];   // LED differs from the base
+
+static HSV     base_hsv;
+static RGB     base_rgb;
+static bool    base_dirty = true;
+static uint8_t last_mode  = 0;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define BIT_GET(map, i)   ((map)[(i) >> 3] & (1 << ((i) & 7)))
+#define BIT_SET(map, i)   ((map)[(i) >> 3] |= (1 << ((i) & 7)))
+#define BIT_CLEAR(map, i) ((map)[(i) >> 3] &= ~(1 << ((i) & 7)))
+
+static uint8_t blend_channel(uint8_t src, uint8_t dst, uint8_t alpha) {
+    return ((uint16_t)src * alpha + (uint16_t)dst * (255 - alpha)) / 255;
+}
+
+/**
+ * Blend all overlays at one LED over the base colour
+ */
+static void compose_led(uint8_t led) {
+    RGB  out     = base_rgb;
+    bool overlay = false;
+
+    for (uint8_t l = 0; l < OVERLAY_COUNT; l++) {
+        const comp_pixel_t *px = &overlays[l][led];
+        if (px->alpha == 0) {
+            continue;
+        }
+        out.r   = blend_channel(px->rgb.r, out.r, px->alpha);
+        out.g   = blend_channel(px->rgb.g, out.g, px->alpha);
+        out.b   = blend_channel(px->rgb.b, out.b, px->alpha);
+        overlay = true;
+    }
+
+    composed[led] = out;
+    if (overlay) {
+        BIT_SET(covered, led);
+    } else {
+        BIT_CLEAR(covered, led);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTIONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void compositor_init(void) {
+    memset(overlays, 0, sizeof(overlays));
+    memset(covered, 0, sizeof(covered));
+    base_hsv   = rgb_matrix_get_hsv();
+    base_dirty = true;
+}
+
+void compositor_set_base(HSV hsv) {
+    if (hsv.h == base_hsv.h && hsv.s == base_hsv.s && hsv.v == base_hsv.v) {
+        return;
+    }
+    base_hsv   = hsv;
+    base_dirty = true;
+}
+
+HSV compositor_get_base(void) {
+    return base_hsv;
+}
+
+void compositor_set(comp_layer_t layer, uint8_t led, RGB rgb, uint8_t alpha) {
+    if (layer == COMP_BASE || layer >= COMP_LAYER_COUNT || led >= RGB_MATRIX_LED_COUNT) {
+        return;
+    }
+
+    // Transparent pixels look the same whatever their colour
+    comp_pixel_t *px = &overlays[layer - 1][led];
+    if (px->alpha == alpha && (alpha == 0 || (px->rgb.r == rgb.r && px->rgb.g == rgb.g && px->rgb.b == rgb.b))) {
+        return;
+    }
+    px->rgb   = rgb;
+    px->alpha = alpha;
+    BIT_SET(dirty, led);
+}
+
+void compositor_clear_layer(comp_layer_t layer) {
+    if (layer == COMP_BASE || layer >= COMP_LAYER_COUNT) {
+        return;
+    }
+
+    comp_pixel_t *pixels = overlays[layer - 1];
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        if (pixels[i].alpha != 0) {
+            pixels[i].alpha = 0;
+            BIT_SET(dirty, i);
+        }
+    }
+}
+
+void compositor_render(void) {
+    uint8_t mode = rgb_matrix_get_mode();
+
+    if (mode != last_mode) {
+        last_mode  = mode;
+        base_dirty = true;
+    }
+
+    // A new base colour changes every blend
+    if (base_dirty) {
+        base_rgb   = hsv_to_rgb(base_hsv);
+        base_dirty = false;
+        memset(dirty, 0xFF, sizeof(dirty));
+    }
+
+    // Re-blend only what changed, a byte of the bitmap at a time
+    for (uint8_t byte = 0; byte < BITMAP_BYTES; byte++) {
+        if (dirty[byte] == 0) {
+            continue;
+        }
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            uint8_t led = (byte << 3) + bit;
+            if (led < RGB_MATRIX_LED_COUNT && (dirty[byte] & (1 << bit))) {
+                compose_led(led);
+            }
+        }
+        dirty[byte] = 0;
+    }
+
+    // The effect has just repainted the buffer in the user's colour. Under
+    // SOLID_COLOR with that colour as the base, only covered LEDs need
+    // writing; otherwise the base is painted here too. The user's HSV is
+    // never touched, so RGB keys adjust and save their own setting.
+    HSV  user  = rgb_matrix_get_hsv();
+    bool solid = mode == RGB_MATRIX_SOLID_COLOR &&
+                 user.h == base_hsv.h && user.s == base_hsv.s && user.v == base_hsv.v;
+
+    for (uint8_t led = 0; led < RGB_MATRIX_LED_COUNT; led++) {
+        if (solid && !BIT_GET(covered, led)) {
+            continue;
+        }
+        rgb_matrix_set_color(led, composed[led].r, composed[led].g, composed[led].b);
+    }
+}
+
+#endif // RGB_MATRIX_ENABLE
@@ -0,0 +1,84 @@
+/**
+ * @file compositor.h
+ * @brief Layered RGB compositor with dirty tracking
+ *
+ * Effects draw into named layers instead of calling rgb_matrix_set_color()
+ * directly. The base layer is a single colour; every other layer is a
+ * per-LED RGB + alpha overlay, blended over the base in priority order.
+ * Only LEDs whose layers changed are re-blended.
+ *
+ * The base is painted with rgb_matrix_set_color() like any overlay, so
+ * rgb_matrix's own HSV (saved to EEPROM by the RGB keys) is left alone.
+ * Only under RGB_MATRIX_SOLID_COLOR with that HSV as the base does the
+ * effect already show it, and compositor_render() writes just the LEDs
+ * that carry an overlay. Otherwise every LED is written.
+ */
+
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "quantum.h"
+
+#ifdef RGB_MATRIX_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// LAYERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Lowest priority first; later layers are blended over earlier ones
+typedef enum {
+    COMP_BASE = 0,          // Uniform background (breathing)
+    COMP_LAYER_INDICATOR,   // Active keymap layer
+    COMP_LOCK_INDICATOR,    // Host lock state
+    COMP_PARTICLES,         // Confetti
+    COMP_LAYER_COUNT
+} comp_layer_t;
+
+#define COMP_ALPHA_OPAQUE 255
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Clear all layers
+ * Call from keyboard_post_init_user() before effects initialise
+ */
+void compositor_init(void);
+
+/**
+ * Set the uniform base colour
+ * @param hsv Colour for every LED not covered by an overlay
+ */
+void compositor_set_base(HSV hsv);
+
+/**
+ * Get the current base colour
+ * @return Colour last passed to compositor_set_base()
+ */
+HSV compositor_get_base(void);
+
+/**
+ * Set one overlay pixel
+ * @param layer Overlay layer (not COMP_BASE)
+ * @param led   LED index
+ * @param rgb   Colour
+ * @param alpha 0 = transparent, COMP_ALPHA_OPAQUE = replaces layers below
+ */
+void compositor_set(comp_layer_t layer, uint8_t led, RGB rgb, uint8_t alpha);
+
+/**
+ * Make every pixel of an overlay layer transparent
+ * @param layer Overlay layer (not COMP_BASE)
+ */
+void compositor_clear_layer(comp_layer_t layer);
+
+/**
+ * Blend dirty LEDs and push the result to the LED buffer
+ * Call at the end of rgb_matrix_indicators_user()
+ */
+void compositor_render(void);
+
+#endif // RGB_MATRIX_ENABLE
+
+#endif // COMPOSITOR_H
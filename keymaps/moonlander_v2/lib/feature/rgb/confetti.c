@@ -7,6 +7,8 @@
  */
 
 #include "confetti.h"
+#include "compositor.h"
+#include "../../util/logger.h"
 
 #ifdef RGB_MATRIX_ENABLE
 
@@ -16,43 +18,43 @@
 // MOONLANDER LED LAYOUT
 // ═══════════════════════════════════════════════════════════════════════════
 
-// Moonlander has 72 LEDs total
-// Left hand: LEDs 0-35 (6 rows × 6 cols)
-// Right hand: LEDs 36-71 (6 rows × 6 cols)
-
-#define LEFT_HAND_START  0
-#define LEFT_HAND_END    35
-#define RIGHT_HAND_START 36
-#define RIGHT_HAND_END   71
-
 #define HAND_WIDTH  6   // 6 columns per hand
 #define HAND_HEIGHT 6   // 6 rows per hand
 
 // Virtual coordinate system spans both hands:
 // X: 0-11 (0-5 = left hand, 6-11 = right hand)
 // Y: 0-5 (rows, 0 = top)
+//
+// It is stretched over the physical LED positions in g_led_config, so
+// X 0-11 covers LED x 0-224 and Y 0-5 covers LED y 0-64.
 
 // ═══════════════════════════════════════════════════════════════════════════
-// PARTICLE DEFINITION
+// PARTICLE STORAGE
 // ═══════════════════════════════════════════════════════════════════════════
 
-typedef struct {
-    // Position (fixed-point: multiply by 16 for sub-LED precision)
-    int16_t x;          // Horizontal position (0-95: 0-5 = right hand, 6-11 = left hand)
-    int16_t y;          // Vertical position (0-95: 0-5 rows × 16)
-    
-    // Velocity (fixed-point)
-    int16_t vx;         // Horizontal velocity (negative = leftward)
-    int16_t vy;         // Vertical velocity (positive = downward initially)
-    
-    // Visual
-    uint8_t hue;        // Color hue (0-255)
-    uint8_t sat;        // Saturation (0-255)
-    
-    // State
-    bool active;        // Is particle alive?
-    uint8_t brightness; // Current brightness (fades on landing)
-} confetti_particle_t;
+// Structure of arrays: live particles are packed into [0, live_count) and a
+// dead particle is replaced by the last live one, so no slot is ever skipped.
+//
+// Position (fixed-point: multiply by 16 for sub-LED precision)
+//   x: 0-176 (columns 0-11 × 16: 0-5 = left hand, 6-11 = right hand)
+//   y: 0-95  (rows 0-5 × 16)
+// Velocity (fixed-point, negative vx = leftward, negative vy = upward)
+
+static int16_t p_x[CONFETTI_PARTICLES];
+static int16_t p_y[CONFETTI_PARTICLES];
+static int16_t p_vx[CONFETTI_PARTICLES];
+static int16_t p_vy[CONFETTI_PARTICLES];
+static uint8_t p_hue[CONFETTI_PARTICLES];
+static uint8_t p_sat[CONFETTI_PARTICLES];
+static uint8_t p_val[CONFETTI_PARTICLES];   // Brightness, fades on bounces
+
+static uint8_t live_count = 0;
+static uint8_t step_cursor = 0;             // Round-robin start when over budget
+
+// LEDs holding a particle after the last frame, so the next one only
+// touches the LEDs particles entered or left
+#define LIT_BYTES ((RGB_MATRIX_LED_COUNT + 7) / 8)
+static uint8_t lit[LIT_BYTES];
 
 // ═══════════════════════════════════════════════════════════════════════════
 // PHYSICS CONSTANTS (all fixed-point: multiply by 16)
@@ -73,15 +75,17 @@ typedef struct {
 // INTERNAL STATE
 // ═══════════════════════════════════════════════════════════════════════════
 
-static confetti_particle_t particles[CONFETTI_PARTICLES];
 static bool confetti_is_active = false;
 static bool confetti_initialized = false;
 
+// Compositor base colour to restore when the burst ends
+static HSV saved_base;
+
 // ═══════════════════════════════════════════════════════════════════════════
 // RANDOM NUMBER GENERATION
 // ═══════════════════════════════════════════════════════════════════════════
 
-static uint16_t rng_seed = 0;
+static uint32_t rng_seed = 0;
 
 static void confetti_seed_rng(void) {
     rng_seed = timer_read();
@@ -103,29 +107,147 @@ static int16_t confetti_rand_range(int16_t min, int16_t max) {
 // LED MAPPING
 // ═══════════════════════════════════════════════════════════════════════════
 
+// Lookup grid at GRID_SHIFT times the virtual resolution (2 cells per unit)
+#define GRID_SHIFT  1
+#define GRID_W      (((HAND_WIDTH * 2 - 1) << GRID_SHIFT) + 1)
+#define GRID_H      (((HAND_HEIGHT - 1) << GRID_SHIFT) + 1)
+
+// Physical extent of g_led_config.point[]
+#define LED_X_MAX   224
+#define LED_Y_MAX   64
+
+static uint8_t led_grid[GRID_H][GRID_W];
+
 /**
- * Convert (x, y) position to LED index
- * x: 0-5 = left hand, 6-11 = right hand
- * y: 0-5 = rows (0 = top)
+ * Fill led_grid with the nearest LED to each cell's physical position
+ * Runs once at init; pos_to_led() is then a single lookup
+ */
+static void build_led_grid(void) {
+    for (uint8_t gy = 0; gy < GRID_H; gy++) {
+        int16_t py = (int16_t)((uint16_t)gy * LED_Y_MAX / (GRID_H - 1));
+
+        for (uint8_t gx = 0; gx < GRID_W; gx++) {
+            int16_t  px        = (int16_t)((uint16_t)gx * LED_X_MAX / (GRID_W - 1));
+            uint8_t  best      = 0;
+            uint16_t best_dist = UINT16_MAX;
+
+            for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+                if (g_led_config.flags[i] == LED_FLAG_NONE) {
+                    continue;
+                }
+                int16_t  dx   = g_led_config.point[i].x - px;
+                int16_t  dy   = g_led_config.point[i].y - py;
+                uint16_t dist = (uint16_t)(dx * dx + dy * dy);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best      = i;
+                }
+            }
+            led_grid[gy][gx] = best;
+        }
+    }
+}
+
+/**
+ * Convert a fixed-point (x, y) position to LED index
+ * x: 0-11 × FIXED_ONE, y: 0-5 × FIXED_ONE (clamped)
  */
 static uint8_t pos_to_led(int16_t x, int16_t y) {
+    int16_t gx = x >> (FIXED_SHIFT - GRID_SHIFT);
+    int16_t gy = y >> (FIXED_SHIFT - GRID_SHIFT);
+
     // Clamp to valid range
-    if (x < 0) x = 0;
-    if (x >= (HAND_WIDTH * 2)) x = (HAND_WIDTH * 2) - 1;
-    if (y < 0) y = 0;
-    if (y >= HAND_HEIGHT) y = HAND_HEIGHT - 1;
-    
-    // Determine which hand
-    if (x < HAND_WIDTH) {
-        // Left hand (LEDs 0-35)
-        // x: 0-5 maps directly to columns
-        return LEFT_HAND_START + (y * HAND_WIDTH) + x;
-    } else {
-        // Right hand (LEDs 36-71)
-        // x: 6-11 maps to local x: 0-5
-        uint8_t local_x = x - HAND_WIDTH;
-        return RIGHT_HAND_START + (y * HAND_WIDTH) + local_x;
+    if (gx < 0) gx = 0;
+    if (gx >= GRID_W) gx = GRID_W - 1;
+    if (gy < 0) gy = 0;
+    if (gy >= GRID_H) gy = GRID_H - 1;
+
+    return led_grid[gy][gx];
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PARTICLE ENGINE
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Remove particle i by moving the last live particle into its slot
+ */
+static void particle_kill(uint8_t i) {
+    uint8_t last = --live_count;
+
+    p_x[i]   = p_x[last];
+    p_y[i]   = p_y[last];
+    p_vx[i]  = p_vx[last];
+    p_vy[i]  = p_vy[last];
+    p_hue[i] = p_hue[last];
+    p_sat[i] = p_sat[last];
+    p_val[i] = p_val[last];
+}
+
+/**
+ * Advance particle i by one frame
+ * @return false if it died (slot i now holds a different particle)
+ */
+static bool particle_step(uint8_t i) {
+    // Apply gravity (downward acceleration)
+    p_vy[i] += GRAVITY;
+
+    // Update position
+    p_x[i] += p_vx[i];
+    p_y[i] += p_vy[i];
+
+    // Bottom boundary (floor)
+    if (p_y[i] >= ((HAND_HEIGHT - 1) * FIXED_ONE)) {
+        p_y[i] = (HAND_HEIGHT - 1) * FIXED_ONE;
+
+        // Bounce with damping
+        p_vy[i] = -p_vy[i] / BOUNCE_DAMP;
+
+        // Apply friction to horizontal velocity
+        p_vx[i] = p_vx[i] * (FRICTION) / (FRICTION + 1);
+
+        // Fade out on each bounce
+        if (p_val[i] > 30) {
+            p_val[i] -= 30;
+        } else {
+            particle_kill(i);
+            return false;
+        }
     }
+
+    // Left boundary (stop at left edge of left hand)
+    if (p_x[i] < 0) {
+        p_x[i] = 0;
+        p_vx[i] = 0;
+
+        // Fade out when hitting left wall
+        if (p_val[i] > 40) {
+            p_val[i] -= 40;
+        } else {
+            particle_kill(i);
+            return false;
+        }
+    }
+
+    // Right boundary (stop at right edge of right hand)
+    if (p_x[i] >= ((HAND_WIDTH * 2 - 1) * FIXED_ONE)) {
+        p_x[i] = (HAND_WIDTH * 2 - 1) * FIXED_ONE;
+        p_vx[i] = -p_vx[i] / 2;
+    }
+
+    // Top boundary (ceiling)
+    if (p_y[i] < 0) {
+        p_y[i] = 0;
+        p_vy[i] = -p_vy[i] / BOUNCE_DAMP;
+    }
+
+    // Kill particles that are barely moving and dim
+    if (p_val[i] < 20 || (abs(p_vx[i]) < 2 && abs(p_vy[i]) < 2)) {
+        particle_kill(i);
+        return false;
+    }
+
+    return true;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -136,21 +258,12 @@ void confetti_init(void) {
     if (confetti_initialized) {
         return;
     }
-    
+
     confetti_seed_rng();
-    
-    // Clear particle array
-    for (uint8_t i = 0; i < CONFETTI_PARTICLES; i++) {
-        particles[i].active = false;
-        particles[i].x = 0;
-        particles[i].y = 0;
-        particles[i].vx = 0;
-        particles[i].vy = 0;
-        particles[i].hue = 0;
-        particles[i].sat = 0;
-        particles[i].brightness = 0;
-    }
-    
+    build_led_grid();
+
+    live_count = 0;
+    step_cursor = 0;
     confetti_is_active = false;
     confetti_initialized = true;
 }
@@ -159,140 +272,96 @@ void confetti_trigger(void) {
     if (!confetti_initialized) {
         confetti_init();
     }
-    
+
+    // Dim the base to black instead of covering every LED with a black
+    // overlay, so only particle LEDs are ever written
+    if (!confetti_is_active) {
+        saved_base = compositor_get_base();
+        HSV black  = { .h = saved_base.h, .s = saved_base.s, .v = 0 };
+        compositor_set_base(black);
+    }
+
     confetti_seed_rng();
     confetti_is_active = true;
-    
+
+    // A new burst replaces whatever is still flying
+    live_count = 0;
+    step_cursor = 0;
+
     // Launch particles from random positions on the RIGHT hand (x: 6-11, y: 0-5)
     for (uint8_t i = 0; i < CONFETTI_PARTICLES; i++) {
         // Start position: somewhere on right hand
         // X: 6-11 (right hand), use fixed-point
-        particles[i].x = (HAND_WIDTH + confetti_rand(HAND_WIDTH)) * FIXED_ONE;
+        p_x[i] = (HAND_WIDTH + confetti_rand(HAND_WIDTH)) * FIXED_ONE;
         // Y: 0-5 (any row)
-        particles[i].y = confetti_rand(HAND_HEIGHT) * FIXED_ONE;
-        
+        p_y[i] = confetti_rand(HAND_HEIGHT) * FIXED_ONE;
+
         // Random leftward and upward velocity
-        particles[i].vx = confetti_rand_range(INITIAL_VX_MIN, INITIAL_VX_MAX);
-        particles[i].vy = confetti_rand_range(INITIAL_VY_MIN, INITIAL_VY_MAX);
-        
+        p_vx[i] = confetti_rand_range(INITIAL_VX_MIN, INITIAL_VX_MAX);
+        p_vy[i] = confetti_rand_range(INITIAL_VY_MIN, INITIAL_VY_MAX);
+
         // Random bright color
-        particles[i].hue = confetti_rand(255);
-        particles[i].sat = 200 + confetti_rand(55);  // 200-255
-        particles[i].brightness = 255;
-        
-        particles[i].active = true;
-        
-#ifdef LOGGING_ENABLE
+        p_hue[i] = confetti_rand(255);
+        p_sat[i] = 200 + confetti_rand(55);  // 200-255
+        p_val[i] = 255;
+
         if (i < 3) {  // Only log first 3 particles
-            dprintf("Particle %d: x=%d y=%d vx=%d vy=%d hue=%d\n", 
-                    i, particles[i].x >> FIXED_SHIFT, particles[i].y >> FIXED_SHIFT,
-                    particles[i].vx, particles[i].vy, particles[i].hue);
+            LOG_DEBUG("Particle %d: x=%d y=%d vx=%d vy=%d hue=%d",
+                      i, p_x[i] >> FIXED_SHIFT, p_y[i] >> FIXED_SHIFT,
+                      p_vx[i], p_vy[i], p_hue[i]);
         }
-#endif
     }
+    live_count = CONFETTI_PARTICLES;
 }
 
 void confetti_update(void) {
     if (!confetti_is_active) {
         return;
     }
-    
-    // CRITICAL: Clear all LEDs first so only confetti particles are visible
-    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
-        rgb_matrix_set_color(i, 0, 0, 0);
-    }
-    
-    bool any_alive = false;
-    
-    // Update physics for each particle
-    for (uint8_t i = 0; i < CONFETTI_PARTICLES; i++) {
-        if (!particles[i].active) {
-            continue;
-        }
-        
-        any_alive = true;
-        
-        // Apply gravity (downward acceleration)
-        particles[i].vy += GRAVITY;
-        
-        // Update position
-        particles[i].x += particles[i].vx;
-        particles[i].y += particles[i].vy;
-        
-        // Convert to LED coordinates (divide by FIXED_ONE)
-        int16_t led_x = particles[i].x >> FIXED_SHIFT;
-        int16_t led_y = particles[i].y >> FIXED_SHIFT;
-        
-        // Boundary checking and bouncing
-        
-        // Bottom boundary (floor)
-        if (particles[i].y >= ((HAND_HEIGHT - 1) * FIXED_ONE)) {
-            particles[i].y = (HAND_HEIGHT - 1) * FIXED_ONE;
-            
-            // Bounce with damping
-            particles[i].vy = -particles[i].vy / BOUNCE_DAMP;
-            
-            // Apply friction to horizontal velocity
-            particles[i].vx = particles[i].vx * (FRICTION) / (FRICTION + 1);
-            
-            // Fade out on each bounce
-            if (particles[i].brightness > 30) {
-                particles[i].brightness -= 30;
-            } else {
-                particles[i].active = false;
-                continue;
-            }
-        }
-        
-        // Left boundary (stop at left edge of left hand)
-        if (particles[i].x < 0) {
-            particles[i].x = 0;
-            particles[i].vx = 0;
-            
-            // Fade out when hitting left wall
-            if (particles[i].brightness > 40) {
-                particles[i].brightness -= 40;
-            } else {
-                particles[i].active = false;
-                continue;
-            }
-        }
-        
-        // Right boundary (stop at right edge of right hand)
-        if (particles[i].x >= ((HAND_WIDTH * 2 - 1) * FIXED_ONE)) {
-            particles[i].x = (HAND_WIDTH * 2 - 1) * FIXED_ONE;
-            particles[i].vx = -particles[i].vx / 2;
-        }
-        
-        // Top boundary (ceiling)
-        if (particles[i].y < 0) {
-            particles[i].y = 0;
-            particles[i].vy = -particles[i].vy / BOUNCE_DAMP;
-        }
-        
-        // Kill particles that are barely moving and dim
-        if (particles[i].brightness < 20 || 
-            (abs(particles[i].vx) < 2 && abs(particles[i].vy) < 2)) {
-            particles[i].active = false;
-            continue;
+
+    // Physics: at most CONFETTI_FRAME_BUDGET steps per frame. Over budget,
+    // the next frame resumes where this one stopped. A frame never wraps:
+    // a death swaps in the last particle, which past the wrap would already
+    // have stepped this frame.
+    for (uint8_t n = 0; n < CONFETTI_FRAME_BUDGET && step_cursor < live_count; n++) {
+        if (particle_step(step_cursor)) {
+            step_cursor++;
         }
-        
-        // Render particle at current position
-        uint8_t led = pos_to_led(led_x, led_y);
-        
+    }
+    if (step_cursor >= live_count) {
+        step_cursor = 0;
+    }
+
+    // Render into the particle layer. compositor_set() ignores a pixel that
+    // keeps its colour, so a particle still on the same LED costs nothing;
+    // only LEDs a particle left are cleared.
+    uint8_t lit_now[LIT_BYTES] = { 0 };
+    for (uint8_t i = 0; i < live_count; i++) {
+        uint8_t led = pos_to_led(p_x[i], p_y[i]);
+
         HSV hsv = {
-            .h = particles[i].hue,
-            .s = particles[i].sat,
-            .v = particles[i].brightness
+            .h = p_hue[i],
+            .s = p_sat[i],
+            .v = p_val[i]
         };
-        
-        RGB rgb = hsv_to_rgb(hsv);
-        rgb_matrix_set_color(led, rgb.r, rgb.g, rgb.b);
+
+        compositor_set(COMP_PARTICLES, led, hsv_to_rgb(hsv), COMP_ALPHA_OPAQUE);
+        lit_now[led >> 3] |= 1 << (led & 7);
     }
-    
+    for (uint8_t byte = 0; byte < LIT_BYTES; byte++) {
+        uint8_t left = lit[byte] & ~lit_now[byte];
+        for (uint8_t bit = 0; left; bit++, left >>= 1) {
+            if (left & 1) {
+                compositor_set(COMP_PARTICLES, (byte << 3) + bit, (RGB){ 0, 0, 0 }, 0);
+            }
+        }
+        lit[byte] = lit_now[byte];
+    }
+
     // Deactivate when all particles are dead
-    if (!any_alive) {
+    if (live_count == 0) {
         confetti_is_active = false;
+        compositor_set_base(saved_base);
     }
 }
 
@@ -21,6 +21,12 @@
 #define CONFETTI_PARTICLES 18           // Number of simultaneous particles
 #endif
 
+#ifndef CONFETTI_FRAME_BUDGET
+#define CONFETTI_FRAME_BUDGET 12        // Physics steps per frame
+#endif
+
+_Static_assert(CONFETTI_PARTICLES <= 255, "CONFETTI_PARTICLES must fit in uint8_t");
+
 // ═══════════════════════════════════════════════════════════════════════════
 // PUBLIC API
 // ═══════════════════════════════════════════════════════════════════════════
@@ -40,8 +46,8 @@ void confetti_trigger(void);
 
 /**
  * Update confetti animation
- * Handles physics simulation and rendering
- * Call from rgb_matrix_indicators_user()
+ * Handles physics simulation and draws into the COMP_PARTICLES layer
+ * Call from rgb_matrix_indicators_user() before compositor_render()
  */
 void confetti_update(void);
 
@@ -0,0 +1,74 @@
+/**
+ * @file indicators.c
+ * @brief Layer and lock indicator implementation
+ */
+
+#include "indicators.h"
+#include "compositor.h"
+#include "../../core/layers.h"
+
+#ifdef RGB_MATRIX_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INTERNAL STATE
+// ═══════════════════════════════════════════════════════════════════════════
+
+static const uint8_t layer_leds[] = INDICATOR_LAYER_LEDS;
+static const uint8_t lock_leds[]  = INDICATOR_LOCK_LEDS;
+
+#define LAYER_LED_COUNT (sizeof(layer_leds) / sizeof(layer_leds[0]))
+#define LOCK_LED_COUNT  (sizeof(lock_leds) / sizeof(lock_leds[0]))
+
+_Static_assert(_LAYER_COUNT <= (1 << LAYER_LED_COUNT), "INDICATOR_LAYER_LEDS too short for every layer");
+_Static_assert(LOCK_LED_COUNT == 3, "INDICATOR_LOCK_LEDS needs one LED per lock: Num, Caps, Scroll");
+
+// Last drawn state; drawn_valid is false until the first draw
+static uint8_t drawn_layer;
+static uint8_t drawn_locks;
+static bool    drawn_valid = false;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// INTERNAL HELPERS
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Light leds[i] where bit i of bits is set, clear the rest
+ */
+static void draw_bits(comp_layer_t layer, const uint8_t *leds, uint8_t count, uint8_t bits, RGB rgb) {
+    for (uint8_t i = 0; i < count; i++) {
+        compositor_set(layer, leds[i], rgb, (bits & (1 << i)) ? COMP_ALPHA_OPAQUE : 0);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PUBLIC FUNCTIONS
+// ═══════════════════════════════════════════════════════════════════════════
+
+void indicators_init(void) {
+    drawn_valid = false;
+}
+
+void indicators_update(void) {
+    uint8_t layer = get_highest_layer(layer_state);
+    led_t   leds  = host_keyboard_led_state();
+    uint8_t locks = (leds.num_lock ? 0b001 : 0) | (leds.caps_lock ? 0b010 : 0) | (leds.scroll_lock ? 0b100 : 0);
+
+    if (drawn_valid && layer == drawn_layer && locks == drawn_locks) {
+        return;
+    }
+
+    if (!drawn_valid || layer != drawn_layer) {
+        HSV hsv = { .h = INDICATOR_LAYER_HUE, .s = 255, .v = INDICATOR_VAL };
+        draw_bits(COMP_LAYER_INDICATOR, layer_leds, LAYER_LED_COUNT, layer, hsv_to_rgb(hsv));
+    }
+    if (!drawn_valid || locks != drawn_locks) {
+        HSV hsv = { .h = INDICATOR_LOCK_HUE, .s = 255, .v = INDICATOR_VAL };
+        draw_bits(COMP_LOCK_INDICATOR, lock_leds, LOCK_LED_COUNT, locks, hsv_to_rgb(hsv));
+    }
+
+    drawn_layer = layer;
+    drawn_locks = locks;
+    drawn_valid = true;
+}
+
+#endif // RGB_MATRIX_ENABLE
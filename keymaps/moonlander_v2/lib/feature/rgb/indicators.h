@@ -0,0 +1,63 @@
+/**
+ * @file indicators.h
+ * @brief Layer and lock indicators drawn through the compositor
+ *
+ * The highest active layer is shown in binary on INDICATOR_LAYER_LEDS
+ * (bit 0 first; the base layer lights nothing). Num, Caps and Scroll Lock
+ * each light one of INDICATOR_LOCK_LEDS. Both draw into their compositor
+ * layers, so confetti particles still go on top.
+ */
+
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include "quantum.h"
+
+#ifdef RGB_MATRIX_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CONFIGURATION
+// ═══════════════════════════════════════════════════════════════════════════
+
+// Top row, outer three keys of the left half
+#ifndef INDICATOR_LAYER_LEDS
+#define INDICATOR_LAYER_LEDS { 0, 5, 10 }
+#endif
+
+// Top row, outer three keys of the right half: Num, Caps, Scroll
+#ifndef INDICATOR_LOCK_LEDS
+#define INDICATOR_LOCK_LEDS { 36, 41, 46 }
+#endif
+
+#ifndef INDICATOR_LAYER_HUE
+#define INDICATOR_LAYER_HUE 170         // Blue
+#endif
+
+#ifndef INDICATOR_LOCK_HUE
+#define INDICATOR_LOCK_HUE 85           // Green
+#endif
+
+#ifndef INDICATOR_VAL
+#define INDICATOR_VAL 180               // Brightness (0-255)
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// PUBLIC API
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Forget the last drawn state so the next update redraws
+ * Call from keyboard_post_init_user() after compositor_init()
+ */
+void indicators_init(void);
+
+/**
+ * Draw layer_state and the host lock LEDs into the indicator layers
+ * Only redraws when either changed; call from rgb_matrix_indicators_user()
+ * before compositor_render()
+ */
+void indicators_update(void);
+
+#endif // RGB_MATRIX_ENABLE
+
+#endif // INDICATORS_H
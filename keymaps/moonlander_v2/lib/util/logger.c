@@ -18,4 +18,81 @@ void log_set_level(log_level_t level) {
     current_log_level = level;
 }
 
+#ifdef LOG_DEFERRED_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Deferred Ring Buffer
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Record layout: [site][nargs << 24 | time & 0xFFFFFF][arg0]...[argN-1]
+
+#define LOG_MASK        (LOG_DEFERRED_WORDS - 1)
+#define LOG_HEADER      2
+#define LOG_TIME_MASK   0x00FFFFFFUL
+
+static log_word_t log_ring[LOG_DEFERRED_WORDS];
+static uint16_t log_head    = 0;   // Next word to write
+static uint16_t log_tail    = 0;   // Next word to print
+static uint16_t log_dropped = 0;   // Records lost to a full buffer
+
+static uint16_t log_used(void) {
+    return (log_head - log_tail) & LOG_MASK;
+}
+
+static log_word_t log_pop(void) {
+    log_word_t word = log_ring[log_tail];
+    log_tail = (log_tail + 1) & LOG_MASK;
+    return word;
+}
+
+void log_defer(const char *site, uint8_t nargs, const log_word_t *args) {
+    // One slot stays empty to tell a full buffer from an empty one
+    if (LOG_HEADER + nargs > (LOG_DEFERRED_WORDS - 1) - log_used()) {
+        log_dropped++;
+        return;
+    }
+
+    uint16_t head = log_head;
+    log_ring[head] = (log_word_t)site;
+    head = (head + 1) & LOG_MASK;
+    log_ring[head] = ((log_word_t)nargs << 24) | (timer_read32() & LOG_TIME_MASK);
+    head = (head + 1) & LOG_MASK;
+    for (uint8_t i = 0; i < nargs; i++) {
+        log_ring[head] = args[i];
+        head = (head + 1) & LOG_MASK;
+    }
+    log_head = head;
+}
+
+void log_task(void) {
+    if (log_used() == 0 || last_input_activity_elapsed() < LOG_DEFERRED_IDLE_MS) {
+        return;
+    }
+
+    if (log_dropped > 0) {
+        uprintf("[WRN] Log buffer full - dropped %u records\n", log_dropped);
+        log_dropped = 0;
+    }
+
+    for (uint8_t n = 0; n < LOG_DEFERRED_FLUSH_PER_SCAN && log_used() > 0; n++) {
+        const char *site   = (const char *)(uintptr_t)log_pop();
+        log_word_t  header = log_pop();
+        uint8_t     nargs  = header >> 24;
+
+        log_word_t args[LOG_DEFERRED_MAX_ARGS] = {0};
+        for (uint8_t i = 0; i < nargs; i++) {
+            log_word_t word = log_pop();
+            if (i < LOG_DEFERRED_MAX_ARGS) {
+                args[i] = word;
+            }
+        }
+
+        // Unused trailing words are ignored by the format string
+        uprintf("%8lu ", (unsigned long)(header & LOG_TIME_MASK));
+        uprintf(site, args[0], args[1], args[2], args[3], args[4], args[5]);
+    }
+}
+
+#endif // LOG_DEFERRED_ENABLE
+
 #endif // LOGGING_ENABLE
@@ -3,6 +3,8 @@
  * @brief Logging utilities for QMK debugging
  * 
  * Provides conditional logging that compiles out when disabled.
+ * With LOG_DEFERRED_ENABLE, log sites only record their arguments and
+ * the text is printed later from log_task().
  */
 
 #ifndef LOGGER_H
@@ -32,21 +34,98 @@ void log_init(log_level_t level);
 // Set log level
 void log_set_level(log_level_t level);
 
-// Logging macros
-#define LOG_ERROR(fmt, ...) \
-    do { if (current_log_level >= LOG_LEVEL_ERROR) uprintf("[ERR] " fmt "\n", ##__VA_ARGS__); } while(0)
+#ifdef LOG_DEFERRED_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Deferred Logging
+// ═══════════════════════════════════════════════════════════════════════════
+//
+// Each log site stores its format string address, a timestamp and its raw
+// arguments as pointer-sized words (32 bits on the keyboard) in a RAM ring
+// buffer; log_task() formats and prints them while the keyboard is idle.
+// %s arguments are stored as pointers, so they must point at static strings.
+
+#ifndef LOG_DEFERRED_WORDS
+#define LOG_DEFERRED_WORDS 256         // Ring buffer size in words (power of two)
+#endif
+
+#ifndef LOG_DEFERRED_IDLE_MS
+#define LOG_DEFERRED_IDLE_MS 50        // Input quiet time before flushing
+#endif
+
+#ifndef LOG_DEFERRED_FLUSH_PER_SCAN
+#define LOG_DEFERRED_FLUSH_PER_SCAN 2  // Records printed per log_task()
+#endif
+
+#define LOG_DEFERRED_MAX_ARGS 6
 
-#define LOG_WARN(fmt, ...) \
-    do { if (current_log_level >= LOG_LEVEL_WARN) uprintf("[WRN] " fmt "\n", ##__VA_ARGS__); } while(0)
+_Static_assert((LOG_DEFERRED_WORDS & (LOG_DEFERRED_WORDS - 1)) == 0,
+               "LOG_DEFERRED_WORDS must be a power of two");
 
-#define LOG_INFO(fmt, ...) \
-    do { if (current_log_level >= LOG_LEVEL_INFO) uprintf("[INF] " fmt "\n", ##__VA_ARGS__); } while(0)
+typedef uintptr_t log_word_t;
 
-#define LOG_DEBUG(fmt, ...) \
-    do { if (current_log_level >= LOG_LEVEL_DEBUG) uprintf("[DBG] " fmt "\n", ##__VA_ARGS__); } while(0)
+// Records are replayed through uprintf with every argument as one word. On
+// the keyboard int, long and the word are all 32 bits; a 64-bit host build
+// reads an int from the low half of its slot.
+_Static_assert(sizeof(long) == sizeof(log_word_t) &&
+               (sizeof(int) == sizeof(log_word_t) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__),
+               "LOG_DEFERRED_ENABLE needs int and long to replay from one word");
 
-#define LOG_TRACE(fmt, ...) \
-    do { if (current_log_level >= LOG_LEVEL_TRACE) uprintf("[TRC] " fmt "\n", ##__VA_ARGS__); } while(0)
+/**
+ * Append a record to the ring buffer (dropped and counted when full)
+ * @param site  Format string of the log site
+ * @param nargs Number of words in args
+ * @param args  Arguments, each widened to one word
+ */
+void log_defer(const char *site, uint8_t nargs, const log_word_t *args);
+
+/**
+ * Print buffered records while input is idle
+ * Call this from matrix_scan_user()
+ */
+void log_task(void);
+
+// Argument counting and widening (up to LOG_DEFERRED_MAX_ARGS)
+#define LOG_COUNT(...) LOG_COUNT_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_COUNT_(_, _1, _2, _3, _4, _5, _6, N, ...) N
+
+#define LOG_WORD(x) ((log_word_t)(x))
+#define LOG_WORDS_0()
+#define LOG_WORDS_1(a)                LOG_WORD(a)
+#define LOG_WORDS_2(a, b)             LOG_WORD(a), LOG_WORD(b)
+#define LOG_WORDS_3(a, b, c)          LOG_WORDS_2(a, b), LOG_WORD(c)
+#define LOG_WORDS_4(a, b, c, d)       LOG_WORDS_3(a, b, c), LOG_WORD(d)
+#define LOG_WORDS_5(a, b, c, d, e)    LOG_WORDS_4(a, b, c, d), LOG_WORD(e)
+#define LOG_WORDS_6(a, b, c, d, e, f) LOG_WORDS_5(a, b, c, d, e), LOG_WORD(f)
+
+#define LOG_CAT(a, b) LOG_CAT_(a, b)
+#define LOG_CAT_(a, b) a##b
+
+#define LOG_EMIT(level, tag, fmt, ...) \
+    do { \
+        if (current_log_level >= level) { \
+            static const char log_site[] PROGMEM = tag fmt "\n"; \
+            const log_word_t log_args[LOG_COUNT(__VA_ARGS__) + 1] = { \
+                LOG_CAT(LOG_WORDS_, LOG_COUNT(__VA_ARGS__))(__VA_ARGS__) }; \
+            log_defer(log_site, LOG_COUNT(__VA_ARGS__), log_args); \
+        } \
+    } while(0)
+
+#else // LOG_DEFERRED_ENABLE not defined
+
+#define log_task() ((void)0)
+
+#define LOG_EMIT(level, tag, fmt, ...) \
+    do { if (current_log_level >= level) uprintf(tag fmt "\n", ##__VA_ARGS__); } while(0)
+
+#endif // LOG_DEFERRED_ENABLE
+
+// Logging macros
+#define LOG_ERROR(fmt, ...) LOG_EMIT(LOG_LEVEL_ERROR, "[ERR] ", fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_EMIT(LOG_LEVEL_WARN,  "[WRN] ", fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_EMIT(LOG_LEVEL_INFO,  "[INF] ", fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_EMIT(LOG_LEVEL_DEBUG, "[DBG] ", fmt, ##__VA_ARGS__)
+#define LOG_TRACE(fmt, ...) LOG_EMIT(LOG_LEVEL_TRACE, "[TRC] ", fmt, ##__VA_ARGS__)
 
 // Log keycode event
 #define LOG_KEY(keycode, pressed) \
@@ -57,6 +136,7 @@ void log_set_level(log_level_t level);
 // No-op implementations
 #define log_init(level) ((void)0)
 #define log_set_level(level) ((void)0)
+#define log_task() ((void)0)
 #define LOG_ERROR(fmt, ...) ((void)0)
 #define LOG_WARN(fmt, ...) ((void)0)
 #define LOG_INFO(fmt, ...) ((void)0)
@@ -4,68 +4,55 @@
  */
 
 #include "send_integer.h"
+#include "send_packed.h"
 
-void send_integer_as_keycodes(int16_t value) {
-    // Handle negative numbers
-    if (value < 0) {
-        tap_code(KC_MINUS);
-        value = -value;
-    }
-    
-    // Handle zero specially
-    if (value == 0) {
-        tap_code(KC_0);
-        return;
-    }
-    
-    // Convert to string (max 5 digits for int16_t)
-    char buffer[7];
-    int8_t i = 0;
-    
-    // Build digits in reverse
-    while (value > 0 && i < 6) {
-        buffer[i++] = '0' + (value % 10);
-        value /= 10;
-    }
-    
-    // Send in correct order
-    while (i > 0) {
-        char c = buffer[--i];
-        if (c == '0') {
-            tap_code(KC_0);
-        } else {
-            tap_code(KC_1 + (c - '1'));
-        }
-    }
-}
+// Sign, up to 6 digits and NUL; wider padding is clamped
+#define INTEGER_BUFFER_SIZE 8
 
-void send_integer_padded(int16_t value, uint8_t width) {
-    // Handle negative
-    bool negative = value < 0;
-    if (negative) {
-        value = -value;
+/**
+ * Format value right-aligned into the end of buffer
+ * @return Pointer to the first character
+ */
+static char *format_integer(char *buffer, int16_t value, uint8_t width) {
+    char *p = buffer + INTEGER_BUFFER_SIZE - 1;
+    *p = '\0';
+
+    // Widen first so -32768 survives negation
+    bool     negative  = value < 0;
+    uint16_t magnitude = negative ? (uint16_t)(-(int32_t)value) : (uint16_t)value;
+
+    if (negative && width > 0) {
         width--; // Account for minus sign
     }
-    
-    // Count digits
-    int16_t temp = value;
-    uint8_t digits = (temp == 0) ? 1 : 0;
-    while (temp > 0) {
+
+    // Build digits in reverse
+    uint8_t digits = 0;
+    do {
+        *--p = '0' + (magnitude % 10);
+        magnitude /= 10;
+        digits++;
+    } while (magnitude > 0);
+
+    // Leading zeros
+    while (digits < width && p > buffer + 1) {
+        *--p = '0';
         digits++;
-        temp /= 10;
     }
-    
-    // Send minus if needed
+
     if (negative) {
-        tap_code(KC_MINUS);
-    }
-    
-    // Send leading zeros
-    while (digits < width) {
-        tap_code(KC_0);
-        width--;
+        *--p = '-';
     }
-    
-    // Send the actual number
-    send_integer_as_keycodes(value);
+    return p;
+}
+
+void send_integer_as_keycodes(int16_t value) {
+    char buffer[INTEGER_BUFFER_SIZE];
+
+    // Rising digit runs (e.g. "1234") go out in a single report pair
+    send_packed_string(format_integer(buffer, value, 0));
+}
+
+void send_integer_padded(int16_t value, uint8_t width) {
+    char buffer[INTEGER_BUFFER_SIZE];
+    send_packed_string(format_integer(buffer, value, width));
 }
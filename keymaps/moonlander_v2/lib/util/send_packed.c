@@ -0,0 +1,100 @@
+/**
+ * @file send_packed.c
+ * @brief Report-packing text emitter implementation
+ */
+
+#include "send_packed.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal State
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint8_t run_keys[SEND_PACKED_MAX_KEYS];
+static uint8_t run_count = 0;
+static bool    run_shift = false;
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal Helpers
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Keys that fit in one report for the active protocol
+ */
+static uint8_t run_capacity(void) {
+#ifdef NKRO_ENABLE
+    if (keymap_config.nkro) {
+        return SEND_PACKED_MAX_KEYS;
+    }
+#endif
+    return KEYBOARD_REPORT_KEYS < SEND_PACKED_MAX_KEYS ? KEYBOARD_REPORT_KEYS : SEND_PACKED_MAX_KEYS;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool send_packed_char(char c) {
+    uint8_t keycode = ascii_to_keycode(c);
+    bool    shift   = ascii_to_shift(c);
+
+    if (keycode == KC_NO || ascii_to_altgr(c)) {
+        bool flushed = run_count > 0;
+        send_packed_flush();
+        send_char(c);
+        return flushed;
+    }
+
+    // Keys pressed in the same report reach the host in usage order, so a
+    // run may only grow with a strictly higher usage (this also splits
+    // repeated characters into separate taps)
+    bool flushed = false;
+    if (run_count > 0 &&
+        (shift != run_shift ||
+         keycode <= run_keys[run_count - 1] ||
+         run_count >= run_capacity())) {
+        send_packed_flush();
+        flushed = true;
+    }
+
+    run_keys[run_count++] = keycode;
+    run_shift             = shift;
+    return flushed;
+}
+
+void send_packed_flush(void) {
+    if (run_count == 0) {
+        return;
+    }
+
+    // Same shift bracketing as send_char(), around the whole run
+    if (run_shift) {
+        register_code(KC_LSFT);
+    }
+
+    for (uint8_t i = 0; i < run_count; i++) {
+        add_key(run_keys[i]);
+    }
+    send_keyboard_report();
+
+#if TAP_CODE_DELAY > 0
+    wait_ms(TAP_CODE_DELAY);
+#endif
+
+    for (uint8_t i = 0; i < run_count; i++) {
+        del_key(run_keys[i]);
+    }
+    send_keyboard_report();
+
+    if (run_shift) {
+        unregister_code(KC_LSFT);
+    }
+
+    run_count = 0;
+}
+
+void send_packed_string(const char *str) {
+    while (*str != '\0') {
+        send_packed_char(*str++);
+    }
+    send_packed_flush();
+}
@@ -0,0 +1,51 @@
+/**
+ * @file send_packed.h
+ * @brief Report-packing text emitter
+ *
+ * Types text with several keys per keyboard report instead of one
+ * press/release pair per character. Consecutive characters are packed
+ * into one press report and one release report while their usages keep
+ * rising and they share the same shift state, which is the order the
+ * host reports newly pressed keys in. Anything else (a repeated or lower
+ * usage, a shift change, a full report) starts a new run, so the host
+ * sees exactly the text the serial send_char() path would produce.
+ */
+
+#ifndef SEND_PACKED_H
+#define SEND_PACKED_H
+
+#include "quantum.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef SEND_PACKED_MAX_KEYS
+#define SEND_PACKED_MAX_KEYS 16        // Keys per run when NKRO is active
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Add a character to the current run
+ * Characters without a plain keycode (AltGr, unmapped) are sent serially
+ * @param c ASCII character
+ * @return true if a previous run was sent to make room
+ */
+bool send_packed_char(char c);
+
+/**
+ * Send the pending run as one press and one release report
+ * Call this before any other key output and at the end of a string
+ */
+void send_packed_flush(void);
+
+/**
+ * Type a plain-text string from RAM with packed reports
+ * @param str NUL-terminated string without SS_* sequences
+ */
+void send_packed_string(const char *str);
+
+#endif // SEND_PACKED_H
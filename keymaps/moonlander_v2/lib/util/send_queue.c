@@ -0,0 +1,146 @@
+/**
+ * @file send_queue.c
+ * @brief Non-blocking SEND_STRING output queue implementation
+ */
+
+#include "send_queue.h"
+#include "send_packed.h"
+#include "logger.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal State
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define QUEUE_MASK (SEND_QUEUE_SIZE - 1)
+
+static char     queue_buf[SEND_QUEUE_SIZE];
+static uint16_t queue_head  = 0;   // Next byte to write
+static uint16_t queue_tail  = 0;   // Next byte to send
+static uint16_t delay_timer = 0;
+static uint16_t delay_ms    = 0;   // Non-zero while an SS_DELAY is running
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal Helpers
+// ═══════════════════════════════════════════════════════════════════════════
+
+static uint16_t queue_used(void) {
+    return (queue_head - queue_tail) & QUEUE_MASK;
+}
+
+static char queue_pop(void) {
+    char c = queue_buf[queue_tail];
+    queue_tail = (queue_tail + 1) & QUEUE_MASK;
+    return c;
+}
+
+/**
+ * Copy a string into the ring buffer if it fits entirely
+ * Keeps SS_* sequences whole, so the drain never sees a partial command
+ */
+static bool queue_push(const char *str, bool progmem) {
+    uint16_t len = 0;
+    while ((progmem ? pgm_read_byte(str + len) : str[len]) != '\0') {
+        len++;
+    }
+
+    // One slot stays empty to tell a full buffer from an empty one
+    if (len > (SEND_QUEUE_SIZE - 1) - queue_used()) {
+        LOG_WARN("Send queue full - dropped %u bytes", len);
+        return false;
+    }
+
+    for (uint16_t i = 0; i < len; i++) {
+        queue_buf[queue_head] = progmem ? pgm_read_byte(str + i) : str[i];
+        queue_head = (queue_head + 1) & QUEUE_MASK;
+    }
+    return true;
+}
+
+/**
+ * Parse the decimal argument of SS_DELAY, terminated by '|'
+ */
+static uint16_t queue_pop_delay(void) {
+    uint16_t ms = 0;
+    while (queue_used() > 0) {
+        char c = queue_pop();
+        if (c == '|') {
+            break;
+        }
+        ms = ms * 10 + (c - '0');
+    }
+    return ms;
+}
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+bool send_queue_push(const char *str) {
+    return queue_push(str, false);
+}
+
+bool send_queue_push_P(const char *str) {
+    return queue_push(str, true);
+}
+
+void send_queue_task(void) {
+    if (delay_ms != 0) {
+        if (timer_elapsed(delay_timer) < delay_ms) {
+            return;
+        }
+        delay_ms = 0;
+    }
+
+    // Plain text is packed into runs; a "tap" is one press/release pair
+    uint8_t taps = 0;
+    while (taps < SEND_QUEUE_TAPS_PER_SCAN && queue_used() > 0) {
+        char c = queue_pop();
+
+        if (c != SS_QMK_PREFIX) {
+            if (send_packed_char(c)) {
+                taps++;
+            }
+            continue;
+        }
+
+        send_packed_flush();
+
+        // Same command encoding as send_string_with_delay()
+        switch (queue_pop()) {
+            case SS_TAP_CODE:
+                tap_code((uint8_t)queue_pop());
+                taps++;
+                break;
+
+            case SS_DOWN_CODE:
+                register_code((uint8_t)queue_pop());
+                break;
+
+            case SS_UP_CODE:
+                unregister_code((uint8_t)queue_pop());
+                break;
+
+            case SS_DELAY_CODE:
+                delay_ms    = queue_pop_delay();
+                delay_timer = timer_read();
+                return;  // Resume on a later scan
+
+            default:
+                break;
+        }
+    }
+
+    // Never leave a run pending across scans
+    send_packed_flush();
+}
+
+bool send_queue_busy(void) {
+    return queue_used() > 0 || delay_ms != 0;
+}
+
+void send_queue_clear(void) {
+    send_packed_flush();
+    queue_head = 0;
+    queue_tail = 0;
+    delay_ms   = 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file send_queue.h
+ * @brief Non-blocking SEND_STRING output queue
+ *
+ * Strings are copied into a ring buffer and typed a few keystrokes per
+ * matrix scan, so long expansions (and SS_DELAY) never stall scanning.
+ * Accepts the same encoding as SEND_STRING, including SS_TAP/SS_DOWN/
+ * SS_UP/SS_DELAY sequences. Plain text goes through send_packed, so one
+ * "tap" can carry several characters.
+ */
+
+#ifndef SEND_QUEUE_H
+#define SEND_QUEUE_H
+
+#include "quantum.h"
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef SEND_QUEUE_SIZE
+#define SEND_QUEUE_SIZE 256            // Ring buffer bytes (power of two)
+#endif
+
+#ifndef SEND_QUEUE_TAPS_PER_SCAN
+#define SEND_QUEUE_TAPS_PER_SCAN 4     // Report pairs sent per send_queue_task()
+#endif
+
+_Static_assert((SEND_QUEUE_SIZE & (SEND_QUEUE_SIZE - 1)) == 0,
+               "SEND_QUEUE_SIZE must be a power of two");
+
+/**
+ * Queued drop-in for SEND_STRING()
+ */
+#define SEND_STRING_QUEUED(string) send_queue_push_P(PSTR(string))
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+/**
+ * Queue a string from RAM
+ * Strings are queued whole or not at all
+ * @param str NUL-terminated SEND_STRING encoded string
+ * @return false if the queue did not have room
+ */
+bool send_queue_push(const char *str);
+
+/**
+ * Queue a string from PROGMEM
+ * @param str NUL-terminated SEND_STRING encoded string in flash
+ * @return false if the queue did not have room
+ */
+bool send_queue_push_P(const char *str);
+
+/**
+ * Type the next few queued keystrokes
+ * Call this from matrix_scan_user()
+ */
+void send_queue_task(void);
+
+/**
+ * Check if output is still pending
+ * @return true if the queue is not empty or a delay is running
+ */
+bool send_queue_busy(void);
+
+/**
+ * Drop all pending output and cancel a running delay
+ */
+void send_queue_clear(void);
+
+#endif // SEND_QUEUE_H
@@ -0,0 +1,143 @@
+/**
+ * @file trace.c
+ * @brief Begin/end event tracing implementation
+ */
+
+#include "trace.h"
+
+#ifdef TRACE_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Clock Source
+// ═══════════════════════════════════════════════════════════════════════════
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+// Cortex-M3/M4 debug registers (fixed addresses, no CMSIS needed)
+#define DEMCR           (*(volatile uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA    (1UL << 24)
+#define DWT_CTRL        (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNTENA   (1UL << 0)
+#define DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004)
+
+#ifndef TRACE_CLOCK_HZ
+#ifdef STM32_SYSCLK
+#define TRACE_CLOCK_HZ STM32_SYSCLK
+#else
+#define TRACE_CLOCK_HZ 72000000UL      // Moonlander STM32F303
+#endif
+#endif
+
+static void clock_start(void) {
+    DEMCR     |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL  |= DWT_CYCCNTENA;
+}
+
+static inline uint32_t clock_now(void) {
+    return DWT_CYCCNT;
+}
+#else
+// No cycle counter - millisecond timer
+#undef TRACE_CLOCK_HZ
+#define TRACE_CLOCK_HZ 1000UL
+
+static void clock_start(void) {}
+
+static inline uint32_t clock_now(void) {
+    return timer_read32();
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Internal State
+// ═══════════════════════════════════════════════════════════════════════════
+
+#define TRACE_MASK (TRACE_BUFFER_SIZE - 1)
+
+typedef struct {
+    uint32_t ticks;
+    uint8_t  site;
+    uint8_t  phase;
+    uint16_t arg;
+} trace_record_t;
+
+static trace_record_t trace_buf[TRACE_BUFFER_SIZE];
+static uint16_t trace_head    = 0;       // Next slot to write
+static uint16_t trace_count   = 0;       // Valid records (up to TRACE_BUFFER_SIZE)
+static bool     trace_paused  = false;   // Set while a dump is running
+static bool     dump_header   = false;   // Header line still to print
+static uint16_t dump_index    = 0;       // Next record to print
+
+static const char *const trace_site_names[TRACE_SITE_COUNT] = {
+    [TRACE_PROCESS_RECORD] = "process_record",
+    [TRACE_MATRIX_SCAN]    = "matrix_scan",
+    [TRACE_RGB_INDICATORS] = "rgb_indicators",
+    [TRACE_POINTING]       = "pointing_task",
+    [TRACE_REPORT]         = "report",
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+void trace_init(void) {
+    clock_start();
+    trace_head   = 0;
+    trace_count  = 0;
+    trace_paused = false;
+}
+
+void trace_event(trace_site_t site, trace_phase_t phase, uint16_t arg) {
+    if (trace_paused) {
+        return;
+    }
+
+    trace_record_t *rec = &trace_buf[trace_head];
+    rec->ticks = clock_now();
+    rec->site  = site;
+    rec->phase = phase;
+    rec->arg   = arg;
+
+    trace_head = (trace_head + 1) & TRACE_MASK;
+    if (trace_count < TRACE_BUFFER_SIZE) {
+        trace_count++;
+    }
+}
+
+void trace_dump(void) {
+    if (trace_paused) {
+        return;
+    }
+    trace_paused = true;
+    dump_header  = true;
+    dump_index   = 0;
+}
+
+void trace_task(void) {
+    if (!trace_paused) {
+        return;
+    }
+
+    if (dump_header) {
+        uprintf("TRACE clock %lu %u\n", (unsigned long)TRACE_CLOCK_HZ, trace_count);
+        dump_header = false;
+        return;
+    }
+
+    // Oldest record first
+    uint16_t first = (trace_head - trace_count) & TRACE_MASK;
+    for (uint8_t n = 0; n < TRACE_DUMP_PER_SCAN && dump_index < trace_count; n++) {
+        const trace_record_t *rec = &trace_buf[(first + dump_index) & TRACE_MASK];
+        uprintf("TRACE %lu %c %s %u\n", (unsigned long)rec->ticks, rec->phase,
+                trace_site_names[rec->site], rec->arg);
+        dump_index++;
+    }
+
+    if (dump_index >= trace_count) {
+        uprintf("TRACE end\n");
+        trace_count  = 0;
+        trace_paused = false;
+    }
+}
+
+#endif // TRACE_ENABLE
@@ -0,0 +1,96 @@
+/**
+ * @file trace.h
+ * @brief Begin/end event tracing for keymap hooks
+ *
+ * Hooks are bracketed with TRACE_BEGIN/TRACE_END, which store a timestamp
+ * into a fixed ring buffer (the most recent events win). Timestamps come
+ * from the DWT cycle counter on Cortex-M3/M4, or timer_read32() elsewhere.
+ * trace_dump() prints the buffer a few lines per scan as "TRACE ..." lines;
+ * tools/trace2chrome.awk turns a console capture into Chrome/Perfetto JSON.
+ *
+ * Compiles out unless TRACE_ENABLE is defined.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "quantum.h"
+
+// Traced sites (keep trace_site_names[] in trace.c in sync)
+typedef enum {
+    TRACE_PROCESS_RECORD = 0,   // process_record_user, arg = keycode
+    TRACE_MATRIX_SCAN,          // matrix_scan_user
+    TRACE_RGB_INDICATORS,       // rgb_matrix_indicators_user
+    TRACE_POINTING,             // pointing_device_task_user
+    TRACE_REPORT,               // housekeeping_task_user, after reports went out
+    TRACE_SITE_COUNT
+} trace_site_t;
+
+#ifdef TRACE_ENABLE
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Configuration
+// ═══════════════════════════════════════════════════════════════════════════
+
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 256          // Events kept (power of two)
+#endif
+
+#ifndef TRACE_DUMP_PER_SCAN
+#define TRACE_DUMP_PER_SCAN 4          // Lines printed per trace_task()
+#endif
+
+_Static_assert((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) == 0,
+               "TRACE_BUFFER_SIZE must be a power of two");
+
+// ═══════════════════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════════════════
+
+typedef enum {
+    TRACE_PHASE_BEGIN = 'B',
+    TRACE_PHASE_END   = 'E',
+    TRACE_PHASE_MARK  = 'i'
+} trace_phase_t;
+
+/**
+ * Start the cycle counter and clear the buffer
+ * Call this from keyboard_post_init_user()
+ */
+void trace_init(void);
+
+/**
+ * Record one event
+ * @param site  Traced site
+ * @param phase Begin, end or instant mark
+ * @param arg   Site-specific argument (e.g. keycode)
+ */
+void trace_event(trace_site_t site, trace_phase_t phase, uint16_t arg);
+
+/**
+ * Start printing the buffer; recording pauses until the dump is done
+ */
+void trace_dump(void);
+
+/**
+ * Print the next few lines of a running dump
+ * Call this from matrix_scan_user(), outside any traced region
+ */
+void trace_task(void);
+
+#define TRACE_BEGIN(site, arg) trace_event(site, TRACE_PHASE_BEGIN, arg)
+#define TRACE_END(site)        trace_event(site, TRACE_PHASE_END, 0)
+#define TRACE_MARK(site, arg)  trace_event(site, TRACE_PHASE_MARK, arg)
+
+#else // TRACE_ENABLE not defined
+
+#define trace_init()           ((void)0)
+#define trace_dump()           ((void)0)
+#define trace_task()           ((void)0)
+#define TRACE_BEGIN(site, arg) ((void)0)
+#define TRACE_END(site)        ((void)0)
+#define TRACE_MARK(site, arg)  ((void)0)
+
+#endif // TRACE_ENABLE
+
+#endif // TRACE_H
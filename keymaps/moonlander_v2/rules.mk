@@ -28,6 +28,12 @@ COUNTER_KEYS_ENABLE = yes
 # Logging (comment out for production builds)
 LOGGING_ENABLE = yes
 
+# Buffer log records and print them while idle (needs LOGGING_ENABLE)
+LOG_DEFERRED_ENABLE = yes
+
+# Hook latency tracing, dumped with TRDUMP (see tools/trace2chrome.awk)
+TRACE_ENABLE = no
+
 # ───────────────────────────────────────────────────────────────────────────
 # RGB MATRIX
 # ───────────────────────────────────────────────────────────────────────────
@@ -62,6 +68,8 @@ LTO_ENABLE = yes
 # Utility files
 SRC += lib/util/logger.c
 SRC += lib/util/send_integer.c
+SRC += lib/util/send_packed.c
+SRC += lib/util/send_queue.c
 
 # Feature: Leader hash
 ifeq ($(strip $(LEADER_HASH_ENABLE)), yes)
@@ -78,10 +86,21 @@ endif
 # Feature: Logging
 ifeq ($(strip $(LOGGING_ENABLE)), yes)
     OPT_DEFS += -DLOGGING_ENABLE
+    ifeq ($(strip $(LOG_DEFERRED_ENABLE)), yes)
+        OPT_DEFS += -DLOG_DEFERRED_ENABLE
+    endif
+endif
+
+# Feature: Tracing
+ifeq ($(strip $(TRACE_ENABLE)), yes)
+    OPT_DEFS += -DTRACE_ENABLE
+    SRC += lib/util/trace.c
 endif
 
 # Feature: RGB breathing
 ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
+    SRC += lib/feature/rgb/compositor.c
+    SRC += lib/feature/rgb/indicators.c
     SRC += lib/feature/rgb/breathing.c
     SRC += lib/feature/rgb/confetti.c
 endif
@@ -0,0 +1,119 @@
+#!/usr/bin/awk -f
+# ═══════════════════════════════════════════════════════════════════════════
+# trace2chrome.awk - convert a TRACE dump from `qmk console` to trace JSON
+#
+# Usage: awk -f tools/trace2chrome.awk console.log > trace.json
+#
+# Open the output in chrome://tracing or ui.perfetto.dev. Each hook gets
+# its own track; the "key_to_report" track spans from the start of the
+# scan that delivered a key event to the report mark after it. Per-hook
+# and latency statistics (us) are printed to stderr.
+# ═══════════════════════════════════════════════════════════════════════════
+
+function track(name) {
+    if (!(name in tid)) {
+        tid[name] = ++ntracks
+        meta = meta sprintf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", ntracks, name)
+    }
+    return tid[name]
+}
+
+function emit(s) {
+    printf "%s%s", (nevents++ ? ",\n" : ""), s
+}
+
+function sample(name, us) {
+    n = ++count[name]
+    samples[name, n] = us
+}
+
+# Insertion sort of samples[name, 1..n]
+function sort_samples(name, n,    i, j, v) {
+    for (i = 2; i <= n; i++) {
+        v = samples[name, i]
+        for (j = i - 1; j >= 1 && samples[name, j] > v; j--) {
+            samples[name, j + 1] = samples[name, j]
+        }
+        samples[name, j + 1] = v
+    }
+}
+
+function pct(name, n, p,    k) {
+    k = int((n - 1) * p + 0.5) + 1
+    return samples[name, k]
+}
+
+BEGIN {
+    hz = 0
+    nevents = 0
+    ntracks = 0
+    meta = ""
+    print "{\"displayTimeUnit\":\"ns\",\"traceEvents\":["
+}
+
+{
+    # Console lines may carry a device prefix before "TRACE"
+    i = index($0, "TRACE ")
+    if (i == 0) next
+    split(substr($0, i), f, " ")
+
+    if (f[2] == "clock") {
+        hz = f[3] + 0
+        base = -1
+        wrap = 0
+        scan_start = -1
+        pending = ""
+        next
+    }
+    if (f[2] == "end" || hz == 0) next
+
+    # Unwrap the 32-bit tick counter
+    ticks = f[2] + 0
+    if (base >= 0 && ticks + wrap < last) wrap += 4294967296
+    ticks += wrap
+    if (base < 0) base = ticks
+    last = ticks
+    us = (ticks - base) * 1000000 / hz
+
+    phase = f[3]
+    name = f[4]
+    arg = f[5] + 0
+    t = track(name)
+
+    if (phase == "B") {
+        begin[name] = us
+        emit(sprintf("{\"name\":\"%s\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"arg\":%d}}", name, us, t, arg))
+        if (name == "matrix_scan") scan_start = us
+        if (name == "process_record" && scan_start >= 0) pending = pending " " arg
+    } else if (phase == "E") {
+        emit(sprintf("{\"name\":\"%s\",\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", name, us, t))
+        if (name in begin) {
+            sample(name, us - begin[name])
+            delete begin[name]
+        }
+    } else {
+        emit(sprintf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}", name, us, t))
+        if (name == "report" && pending != "") {
+            lt = track("key_to_report")
+            emit(sprintf("{\"name\":\"key_to_report\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"keycodes\":\"%s\"}}",
+                         scan_start, us - scan_start, lt, substr(pending, 2)))
+            sample("key_to_report", us - scan_start)
+            pending = ""
+        }
+    }
+}
+
+END {
+    print meta
+    print "]}"
+
+    printf "%-16s %6s %10s %10s %10s %10s\n", "site", "count", "p50", "p95", "max", "mean" > "/dev/stderr"
+    for (name in count) {
+        n = count[name]
+        sort_samples(name, n)
+        sum = 0
+        for (k = 1; k <= n; k++) sum += samples[name, k]
+        printf "%-16s %6d %10.1f %10.1f %10.1f %10.1f\n", name, n,
+               pct(name, n, 0.50), pct(name, n, 0.95), samples[name, n], sum / n > "/dev/stderr"
+    }
+}
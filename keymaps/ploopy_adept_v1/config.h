@@ -8,12 +8,14 @@
 #define PLOOPY_DRAGSCROLL_DPI 100
 #define PLOOPY_DRAGSCROLL_INVERT_Y
 #define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+#define WHEEL_EXTENDED_REPORT
 
-#define ACCEL_OFFSET 10
-#define ACCEL_SLOPE 1.5
-#define ACCEL_LIMIT 4.0
+#define CURSOR_ACCEL_OFFSET 10
+#define CURSOR_ACCEL_SLOPE 1.5
+#define CURSOR_ACCEL_LIMIT 4.0
 
-#define SCROLL_SENSITIVITY 0.9f
+#define SCROLL_SENSITIVITY_Q8 230
 
 #define NAV_THRESHOLD 450
 #define NAV_COOLDOWN 300
@@ -8,8 +8,10 @@
  * ======================================== */
 
 #include QMK_KEYBOARD_H
-#include <math.h>
 #include <stdlib.h>
+#include "lib/pointing/cursor.h"
+#include "lib/pointing/scroll.h"
+#include "lib/pointing/sensor.h"
 
 #ifdef LOCKSTATE_ENABLE
 #include "shared/lockstate/lockstate.h"
@@ -64,8 +66,8 @@ static int16_t nav_acum_x = 0;
 static int16_t nav_acum_y = 0;
 static int16_t media_acum_x = 0;
 static int16_t media_acum_y = 0;
-static float scroll_accum_x = 0.0f;
-static float scroll_accum_y = 0.0f;
+static scroll_state_t scroll_state;
+static scroll_state_t zoom_state;
 
 static uint16_t last_nav_time = 0;
 static uint16_t zoom_timer = 0;
@@ -76,7 +78,6 @@ static const uint16_t dpi_levels[] = {400, 800, 1600};
 static const uint8_t dpi_levels_count = sizeof(dpi_levels) / sizeof(dpi_levels[0]);
 
 #ifdef LOCKSTATE_ENABLE
-static uint16_t saved_dpi = 800;
 static bool cursor_frozen = false;
 static bool gestures_disabled = false;
 
@@ -84,8 +85,7 @@ static void lockstate_apply_remote(lock_state_t state) {
     switch (state) {
         case LOCK_STATE_ML_NAV:
             // precision mode
-            saved_dpi = dpi_levels[current_dpi_index];
-            pointing_device_set_cpi(400);
+            sensor_cpi_override(400);
             break;
 
         case LOCK_STATE_ML_NUM:
@@ -101,11 +101,7 @@ static void lockstate_apply_remote(lock_state_t state) {
             cursor_frozen = false;
             gestures_disabled = false;
             // restore dpi if we overrode it
-            if (pointing_device_get_cpi && saved_dpi) {
-                pointing_device_set_cpi(saved_dpi);
-            } else {
-                pointing_device_set_cpi(dpi_levels[current_dpi_index]);
-            }
+            sensor_cpi_release();
             break;
     }
 }
@@ -157,6 +153,7 @@ void scroll_click_reset(tap_dance_state_t *state, void *user_data) {
     (void)state;
     (void)user_data;
     is_scroll_mode = false;
+    scroll_release(&scroll_state);
 }
 
 void mr_click_finished(tap_dance_state_t *state, void *user_data) {
@@ -338,7 +335,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case DPI_CYCLE:
             if (record->event.pressed) {
                 current_dpi_index = (current_dpi_index + 1) % dpi_levels_count;
-                pointing_device_set_cpi(dpi_levels[current_dpi_index]);
+                sensor_cpi_set_base(dpi_levels[current_dpi_index]);
             }
             return false;
 
@@ -359,11 +356,12 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
     if (lockstate_is_moonlander(s) || s == LOCK_STATE_IDLE) {
         cursor_frozen = (s == LOCK_STATE_ML_NUM);
 
+        /* runs every pass; the sensor shadow only writes on a change */
         if (s == LOCK_STATE_IDLE) {
             gestures_disabled = false;
-            pointing_device_set_cpi(dpi_levels[current_dpi_index]);
+            sensor_cpi_release();
         } else if (s == LOCK_STATE_ML_NAV) {
-            pointing_device_set_cpi(400);
+            sensor_cpi_override(400);
         } else if (s == LOCK_STATE_ML_MACRO) {
             gestures_disabled = true;
         }
@@ -373,6 +371,7 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
     lockstate_broadcast_ploopy();
 
     if (cursor_frozen) {
+        scroll_stop(&scroll_state);
         mouse_report.x = 0;
         mouse_report.y = 0;
         mouse_report.v = 0;
@@ -390,14 +389,13 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
         last_nav_time = timer_read();
     }
 
+    /* any motion outside drag-scroll cancels its momentum */
+    if (!is_scroll_mode && (mouse_report.x != 0 || mouse_report.y != 0)) {
+        scroll_stop(&scroll_state);
+    }
+
     if (!is_nav_mode && !is_overview_mode && !is_scroll_mode && !IS_LAYER_ON(_MEDIA) && !is_zoom_mode) {
-        float speed = sqrtf((float)mouse_report.x * (float)mouse_report.x + (float)mouse_report.y * (float)mouse_report.y);
-        if (speed > ACCEL_OFFSET) {
-            float factor = 1.0f + powf(speed - ACCEL_OFFSET, 2) * 0.001f * ACCEL_SLOPE;
-            if (factor > ACCEL_LIMIT) factor = ACCEL_LIMIT;
-            mouse_report.x = (int16_t)((float)mouse_report.x * factor);
-            mouse_report.y = (int16_t)((float)mouse_report.y * factor);
-        }
+        cursor_apply_acceleration(&mouse_report.x, &mouse_report.y);
     }
 
     if (is_nav_mode) {
@@ -438,17 +436,14 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
         mouse_report.x = 0;
         mouse_report.y = 0;
     } else if (is_scroll_mode) {
-        scroll_accum_x += (float)mouse_report.x * SCROLL_SENSITIVITY;
-        scroll_accum_y += (float)mouse_report.y * SCROLL_SENSITIVITY;
-
-        int8_t v_scroll = (int8_t)(scroll_accum_y * -1.0f);
-        int8_t h_scroll = (int8_t)(scroll_accum_x);
+        int16_t h_scroll, v_scroll;
 
-        mouse_report.v = v_scroll;
-        mouse_report.h = h_scroll;
+        scroll_accumulate(&scroll_state, mouse_report.x, mouse_report.y);
+        scroll_coast(&scroll_state);
+        scroll_consume(&scroll_state, &h_scroll, &v_scroll, HV_REPORT_MAX);
 
-        if (mouse_report.v != 0) scroll_accum_y -= (float)(mouse_report.v * -1);
-        if (mouse_report.h != 0) scroll_accum_x -= (float)(mouse_report.h);
+        mouse_report.v = (mouse_hv_report_t)v_scroll;
+        mouse_report.h = (mouse_hv_report_t)h_scroll;
 
         mouse_report.x = 0;
         mouse_report.y = 0;
@@ -477,27 +472,49 @@ report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
         mouse_report.v = 0;
         mouse_report.h = 0;
     } else if (is_zoom_mode) {
-        mouse_report.v = -mouse_report.y;
+        /* one detent per count, in hi-res units when enabled */
+        int16_t h_zoom, v_zoom;
+
+        scroll_accumulate(&zoom_state, 0, mouse_report.y);
+        scroll_consume(&zoom_state, &h_zoom, &v_zoom, HV_REPORT_MAX);
+
+        mouse_report.v = (mouse_hv_report_t)v_zoom;
         mouse_report.x = 0;
         mouse_report.y = 0;
         mouse_report.h = 0;
     }
 
+    if (!is_scroll_mode && scroll_coast(&scroll_state)) {
+        int16_t h_scroll, v_scroll;
+
+        scroll_consume(&scroll_state, &h_scroll, &v_scroll, HV_REPORT_MAX);
+
+        mouse_report.v = (mouse_hv_report_t)v_scroll;
+        mouse_report.h = (mouse_hv_report_t)h_scroll;
+    }
+
     return mouse_report;
 }
 
 void keyboard_post_init_user(void) {
-    pointing_device_set_cpi(dpi_levels[DEFAULT_DPI_INDEX]);
+    sensor_cpi_init(dpi_levels[DEFAULT_DPI_INDEX]);
+    scroll_init(&scroll_state, SCROLL_SENSITIVITY_Q8, SCROLL_RESOLUTION);
+    scroll_init(&zoom_state, 256, SCROLL_RESOLUTION);
 
 #ifdef LOCKSTATE_ENABLE
     cursor_frozen = false;
     gestures_disabled = false;
-    saved_dpi = dpi_levels[DEFAULT_DPI_INDEX];
     lockstate_init(LOCK_ROLE_SECONDARY);
 #endif
 }
 
 #ifdef LOCKSTATE_ENABLE
+/* host LED report: queued, handled by the next lockstate_task() pass */
+bool led_update_user(led_t led_state) {
+    lockstate_led_update(led_state.raw);
+    return true;
+}
+
 void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
     (void)old_state;
 
@@ -512,9 +529,15 @@ void lockstate_on_sync_request(void) {
     cursor_frozen = false;
     gestures_disabled = false;
     is_scroll_mode = false;
+    scroll_stop(&scroll_state);
     is_zoom_mode = false;
     if (IS_LAYER_ON(_MEDIA)) layer_off(_MEDIA);
-    pointing_device_set_cpi(dpi_levels[DEFAULT_DPI_INDEX]);
+    current_dpi_index = DEFAULT_DPI_INDEX;
+    // Base first, so the forced rewrite on release carries the default
+    // level instead of writing the old one and then the new
+    sensor_cpi_set_base(dpi_levels[DEFAULT_DPI_INDEX]);
+    sensor_cpi_invalidate();
+    sensor_cpi_release();
 }
 #endif
 
@@ -15,3 +15,6 @@ PLOOPY_DRAGSCROLL_ENABLE = no
 LTO_ENABLE = yes
 
 SRC += shared/lockstate/lockstate.c
+SRC += lib/pointing/cursor.c
+SRC += lib/pointing/scroll.c
+SRC += lib/pointing/sensor.c
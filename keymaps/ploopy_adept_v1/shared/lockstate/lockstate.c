@@ -20,7 +20,20 @@ lockstate_state_t lockstate = {
     .role = LOCK_ROLE_PRIMARY,  // Default to primary (Moonlander)
     .last_change_time = 0,
     .last_poll_time = 0,
-    .sync_requested = false
+    .event_time = 0,
+    .event_state = LOCK_STATE_IDLE,
+    .write_time = 0,
+    .write_target = LOCK_STATE_IDLE,
+    .write_prev = LOCK_STATE_IDLE,
+    .write_expect = LOCK_STATE_IDLE,
+    .write_held = KC_NO,
+    .echo_ms = 0,
+    .writing = false,
+    .sync_requested = false,
+    .event_pending = false,
+    .events_seen = false,
+    .write_failures = 0,
+    .write_late = 0
 };
 
 /* ========================================
@@ -33,6 +46,16 @@ void lockstate_init(lock_role_t role) {
     lockstate.last_change_time = timer_read();
     lockstate.last_poll_time = timer_read();
     lockstate.sync_requested = false;
+    lockstate.event_pending = false;
+    lockstate.events_seen = false;
+    lockstate.echo_ms = 0;
+    
+    // Drop a write left over from before
+    if (lockstate.write_held) {
+        unregister_code(lockstate.write_held);
+        lockstate.write_held = KC_NO;
+    }
+    lockstate.writing = false;
     
     // Set initial state to IDLE
     lockstate_set(LOCK_STATE_IDLE);
@@ -43,6 +66,80 @@ void lockstate_init(lock_role_t role) {
 #endif
 }
 
+/* ========================================
+ * LOCK KEY WRITES
+ * ======================================== */
+
+/**
+ * @brief Advance the write in flight by at most one lock key
+ * 
+ * Releases the key pressed last step, then waits for its echo before
+ * pressing the next lock that differs, Num first and Scroll last. A
+ * write never blocks the caller or races its own echoes.
+ */
+static void lockstate_write_step(void) {
+    // The host toggles on the press; the release only ends the tap
+    if (lockstate.write_held) {
+        unregister_code(lockstate.write_held);
+        lockstate.write_held = KC_NO;
+    }
+    
+    lock_state_t current = lockstate_get();
+    uint16_t waited = timer_elapsed(lockstate.write_time);
+    
+    if (current != lockstate.write_expect) {
+        if (current == lockstate.write_prev && waited < LOCKSTATE_ECHO_LOST) {
+            return;  // Echo still on its way, however slow
+        }
+        // Never echoed, or someone else toggled a lock: give up and let
+        // the conflict check sort out what the LEDs should be
+#ifdef LOGGING_ENABLE
+        LOG_WARN("Lock write to %s abandoned at %s",
+                 lockstate_name(lockstate.write_target), lockstate_name(current));
+#endif
+        lockstate.writing = false;
+        lockstate.write_failures++;
+        return;
+    }
+    
+    // Echo of the key in flight: track the slowest, letting it decay
+    if (lockstate.write_prev != lockstate.write_expect) {
+        uint8_t echo = waited > UINT8_MAX ? UINT8_MAX : waited;
+        if (waited >= LOCKSTATE_ECHO_TIMEOUT) {
+            lockstate.write_late++;
+        }
+        if (echo >= lockstate.echo_ms) {
+            lockstate.echo_ms = echo;
+        } else {
+            lockstate.echo_ms -= (lockstate.echo_ms - echo + 3) / 4;
+        }
+    }
+    
+    uint8_t diff = (uint8_t)current ^ (uint8_t)lockstate.write_target;
+    if (!diff) {
+        lockstate.writing = false;
+        return;
+    }
+    
+    uint8_t bit = diff & -diff;
+    lockstate.write_prev = current;
+    lockstate.write_expect = (lock_state_t)(current ^ bit);
+    lockstate.write_time = timer_read();
+    lockstate.write_held = bit == 0b001 ? KC_NUM_LOCK
+                         : bit == 0b010 ? KC_CAPS_LOCK
+                         : KC_SCROLL_LOCK;
+    register_code(lockstate.write_held);
+}
+
+bool lockstate_writing(void) {
+    return lockstate.writing;
+}
+
+uint16_t lockstate_settle_ms(void) {
+    uint16_t settle = lockstate.echo_ms + lockstate.echo_ms / 2;
+    return settle > LOCKSTATE_EVENT_SETTLE ? settle : LOCKSTATE_EVENT_SETTLE;
+}
+
 /* ========================================
  * CORE FUNCTIONS
  * ======================================== */
@@ -56,17 +153,17 @@ void lockstate_set(lock_state_t state) {
         return;
     }
     
+#ifdef LOGGING_ENABLE
     lock_state_t old_state = lockstate.cached_state;
+#endif
     
-    // Encode state into lock LEDs
-    led_t led_state = {
-        .num_lock    = (state & 0b001) ? 1 : 0,
-        .caps_lock   = (state & 0b010) ? 1 : 0,
-        .scroll_lock = (state & 0b100) ? 1 : 0
-    };
-    
-    // Write to OS (HID LED report)
-    host_keyboard_leds(led_state);
+    // Start (or retarget) the lock key write; lockstate_task() finishes it
+    if (!lockstate.writing) {
+        lockstate.write_prev = lockstate.write_expect = lockstate_get();
+        lockstate.writing = true;
+    }
+    lockstate.write_target = state;
+    lockstate_write_step();
     
     // Update cache
     lockstate.cached_state = state;
@@ -107,18 +204,10 @@ bool lockstate_is_owned(lock_state_t state) {
 }
 
 /* ========================================
- * POLLING & TASK
+ * STATE CHANGE HANDLING
  * ======================================== */
 
-void lockstate_task(void) {
-    // Rate limit polling
-    if (timer_elapsed(lockstate.last_poll_time) < LOCKSTATE_POLL_INTERVAL) {
-        return;
-    }
-    lockstate.last_poll_time = timer_read();
-    
-    // Read current state from OS
-    lock_state_t current_state = lockstate_get();
+static void lockstate_process(lock_state_t current_state) {
     lock_state_t cached_state = lockstate.cached_state;
     
     // Handle SYNC_REQ (emergency reset)
@@ -169,6 +258,62 @@ void lockstate_task(void) {
     }
 }
 
+/* ========================================
+ * EVENTS, POLLING & TASK
+ * ======================================== */
+
+void lockstate_led_update(uint8_t leds) {
+    lockstate.events_seen = true;
+    if (lockstate_intercept((lock_state_t)(leds & 0b111))) {
+        lockstate.event_pending = false;
+        return;
+    }
+    
+    // Queue only; the settle delay skips intermediate multi-lock states
+    lockstate.event_state = (lock_state_t)(leds & 0b111);
+    lockstate.event_time = timer_read();
+    lockstate.event_pending = true;
+}
+
+void lockstate_task(void) {
+    // A half-applied write is never judged; events wait until it lands
+    if (lockstate.writing) {
+        lockstate_write_step();
+        if (lockstate.writing) {
+            return;
+        }
+    }
+    
+    // Event path: handle the latest LED report once it has settled
+    if (lockstate.event_pending) {
+        if (timer_elapsed(lockstate.event_time) < lockstate_settle_ms()) {
+            return;
+        }
+        lockstate.event_pending = false;
+        lockstate.last_poll_time = timer_read();
+        // Asked again: a frame may have started since the event
+        if (!lockstate_intercept(lockstate.event_state)) {
+            lockstate_process(lockstate.event_state);
+        }
+        return;
+    }
+    
+    // Poll path: full rate until events arrive, then only as a fallback
+    // (a held SYNC_REQ keeps the full rate for its release check)
+    uint16_t interval = (lockstate.events_seen && !lockstate.sync_requested)
+                      ? LOCKSTATE_FALLBACK_INTERVAL
+                      : LOCKSTATE_POLL_INTERVAL;
+    if (timer_elapsed(lockstate.last_poll_time) < interval) {
+        return;
+    }
+    lockstate.last_poll_time = timer_read();
+    
+    lock_state_t current_state = lockstate_get();
+    if (!lockstate_intercept(current_state)) {
+        lockstate_process(current_state);
+    }
+}
+
 /* ========================================
  * EMERGENCY SYNC
  * ======================================== */
@@ -219,6 +364,13 @@ __attribute__((weak)) void lockstate_on_sync_request(void) {
     // Override in keymap.c to reset device state
 }
 
+__attribute__((weak)) bool lockstate_intercept(lock_state_t state) {
+    // Default: lockstate handles every state
+    // Overridden by lockframe.c while it borrows the LEDs
+    (void)state;
+    return false;
+}
+
 /* ========================================
  * DEBUG LOGGING
  * ======================================== */
@@ -5,7 +5,8 @@
  * 
  * Protocol: 3-bit encoding using Num/Caps/Scroll locks
  * Devices: Moonlander (primary) ↔ Ploopy Adept (secondary)
- * Latency: ~50ms (poll-based, configurable)
+ * Latency: ~LOCKSTATE_EVENT_SETTLE with lockstate_led_update() wired to
+ *          led_update_user(), else ~50ms (poll-based, configurable)
  * ======================================== */
 
 #pragma once
@@ -61,6 +62,31 @@ typedef enum {
 #define LOCKSTATE_SYNC_HOLD 1000    // Hold SYNC_REQ for 1 second
 #endif
 
+#ifndef LOCKSTATE_FALLBACK_INTERVAL
+#define LOCKSTATE_FALLBACK_INTERVAL 500  // Consistency poll once LED events arrive
+#endif
+
+#ifndef LOCKSTATE_EVENT_SETTLE
+#define LOCKSTATE_EVENT_SETTLE 4    // Quiet time before an LED event is handled
+#endif
+
+/**
+ * QMK cannot set the host LEDs, so a write presses the lock keys that
+ * differ: one press per lockstate_task(), released on the next, each
+ * waiting for its host echo. An echo normally lands within
+ * LOCKSTATE_ECHO_TIMEOUT; a later one is slow, not lost, because pressing
+ * again would toggle the lock back once it lands. The write only gives
+ * up after LOCKSTATE_ECHO_LOST. Never tap_code(): QMK holds Caps Lock for
+ * TAP_HOLD_CAPS_DELAY inside it, stalling the whole scan.
+ */
+#ifndef LOCKSTATE_ECHO_TIMEOUT
+#define LOCKSTATE_ECHO_TIMEOUT 12   // Expected host echo of one lock key
+#endif
+
+#ifndef LOCKSTATE_ECHO_LOST
+#define LOCKSTATE_ECHO_LOST 100     // Abandon a write whose echo never came
+#endif
+
 /* ========================================
  * CORE API
  * ======================================== */
@@ -79,12 +105,30 @@ void lockstate_init(lock_role_t role);
  * @brief Set lock state (write to OS)
  * 
  * Encodes 3-bit state into Num/Caps/Scroll lock LEDs
- * Updates cached state and timestamp
+ * Updates cached state and timestamp; the first lock key goes out now
+ * and lockstate_task() presses the rest as their echoes arrive
  * 
  * @param state Lock state to write (0-7)
  */
 void lockstate_set(lock_state_t state);
 
+/**
+ * @brief Check if a lock key write is still in flight
+ * 
+ * @return true until the LEDs match the last lockstate_set()
+ */
+bool lockstate_writing(void);
+
+/**
+ * @brief Quiet time before an LED event is acted on
+ * 
+ * The peer's multi-lock writes land one echo apart, so this grows to
+ * 1.5x the slowest recent echo, never below LOCKSTATE_EVENT_SETTLE
+ * 
+ * @return Settle time in milliseconds
+ */
+uint16_t lockstate_settle_ms(void);
+
 /**
  * @brief Get current lock state (read from OS)
  * 
@@ -99,11 +143,25 @@ lock_state_t lockstate_get(void);
  * @brief Poll lock state and handle changes
  * 
  * Call in matrix_scan_user() for continuous polling
+ * Handles queued LED events first, then falls back to polling
  * Detects remote state changes and invokes callbacks
  * Implements timeout and conflict resolution
  */
 void lockstate_task(void);
 
+/**
+ * @brief Queue a host LED report for the next lockstate_task()
+ * 
+ * Call from led_update_user() with led_state.raw; Num/Caps/Scroll sit
+ * in bits 0-2 exactly as in lock_state_t. The event is handled once the
+ * LEDs have been quiet for lockstate_settle_ms(), so the intermediate
+ * states of a multi-lock write are skipped. After the first event,
+ * polling drops to LOCKSTATE_FALLBACK_INTERVAL as a consistency check.
+ * 
+ * @param leds Raw host LED bitmap
+ */
+void lockstate_led_update(uint8_t leds);
+
 /**
  * @brief Get cached lock state (no OS read)
  * 
@@ -158,6 +216,19 @@ void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state);
  */
 void lockstate_on_sync_request(void);
 
+/**
+ * @brief Hook for a layer that borrows the lock LEDs
+ * 
+ * Sees every LED state before lockstate does: from lockstate_led_update()
+ * and again when the state is handled, by event or poll. Return true to
+ * keep lockstate from acting on it. The weak default returns false;
+ * lockframe.c overrides it to receive frames.
+ * 
+ * @param state Lock state on the LEDs
+ * @return true if the state is consumed
+ */
+bool lockstate_intercept(lock_state_t state);
+
 /* ========================================
  * UTILITY FUNCTIONS
  * ======================================== */
@@ -231,7 +302,20 @@ typedef struct {
     lock_role_t role;
     uint16_t last_change_time;
     uint16_t last_poll_time;
+    uint16_t event_time;       // Last lockstate_led_update()
+    lock_state_t event_state;  // State reported by that update
+    uint16_t write_time;       // Lock key of the write in flight pressed
+    lock_state_t write_target;
+    lock_state_t write_prev;   // LEDs before that key
+    lock_state_t write_expect; // LEDs once it is echoed
+    uint8_t write_held;        // Lock key to release next task, or KC_NO
+    uint8_t echo_ms;           // Slowest recent echo, decaying
+    bool writing;
     bool sync_requested;
+    bool event_pending;
+    bool events_seen;          // Event-driven; polling is only a fallback
+    uint16_t write_failures;   // Writes abandoned
+    uint16_t write_late;       // Echoes past LOCKSTATE_ECHO_TIMEOUT
 } lockstate_state_t;
 
 // Extern declaration (defined in lockstate.c)
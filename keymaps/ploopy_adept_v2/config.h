@@ -4,6 +4,8 @@
 #define PLOOPY_DRAGSCROLL_DPI 100
 #define PLOOPY_DRAGSCROLL_INVERT_Y
 #define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+#define WHEEL_EXTENDED_REPORT
 
 #define TAPPING_TERM 200
 #define POINTING_DEVICE_TASK_THROTTLE_MS 1
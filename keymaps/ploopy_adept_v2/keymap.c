@@ -4,12 +4,23 @@
 #include "lib/pointing/accumulators.h"
 #include "lib/pointing/cursor.h"
 #include "lib/pointing/scroll.h"
+#include "lib/pointing/subpixel.h"
+#include "lib/pointing/pipeline.h"
+#include "lib/pointing/sensor.h"
 
 enum custom_keycodes {
     ZOOM_MODE = SAFE_RANGE,
-    DPI_CYCLE
+    DPI_CYCLE,
+    PIPE_STATS
 };
 
+#ifdef PIPELINE_TIMING_ENABLE
+#define CFG_STATS PIPE_STATS
+static void print_pipeline_stats(void);
+#else
+#define CFG_STATS _______
+#endif
+
 enum { TD_SCROLL_CLICK, TD_MR_CLICK, TD_MEDIA_CTRL, TD_NAV_OVERVIEW };
 enum combos { COMBO_CONFIG_LAYER, COMBO_BOOTLOADER };
 enum layers { _BASE, _NAV, _SCROLL, _MEDIA, _CONFIG };
@@ -22,7 +33,9 @@ static bool is_zoom_mode = false;
 static gesture_detector_t nav_gesture;
 static gesture_detector_t media_gesture;
 static scroll_state_t scroll_state;
+static scroll_state_t zoom_state;
 static cursor_state_t cursor_state;
+static subpixel_t cursor_subpixel;
 
 static uint16_t zoom_timer = 0;
 static uint16_t boot_combo_timer = 0;
@@ -50,6 +63,7 @@ void scroll_click_finished(tap_dance_state_t *state, void *user_data) {
 void scroll_click_reset(tap_dance_state_t *state, void *user_data) {
     (void)state; (void)user_data;
     is_scroll_mode = false;
+    scroll_release(&scroll_state);
 }
 
 void mr_click_finished(tap_dance_state_t *state, void *user_data) {
@@ -68,7 +82,7 @@ void media_ctrl_finished(tap_dance_state_t *state, void *user_data) {
             tap_code(QK_MOUSE_BUTTON_4);
         } else {
             layer_on(_MEDIA);
-            gesture_init(&media_gesture, 150, 0);
+            gesture_init(&media_gesture, 150, 0, true);
         }
     }
 }
@@ -84,13 +98,13 @@ void nav_overview_finished(tap_dance_state_t *state, void *user_data) {
         if (state->pressed) {
             is_nav_mode = true;
             layer_on(_NAV);
-            gesture_init(&nav_gesture, 450, 300);
+            gesture_init(&nav_gesture, 450, 300, false);
         }
     } else if (state->count == 2) {
         if (state->pressed) {
             is_overview_mode = true;
             layer_on(_NAV);
-            gesture_init(&nav_gesture, 450, 300);
+            gesture_init(&nav_gesture, 450, 300, false);
         }
     }
 }
@@ -143,7 +157,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
     [_NAV] = LAYOUT(_______, _______, _______, _______, _______, _______),
     [_SCROLL] = LAYOUT(_______, _______, _______, _______, _______, _______),
     [_MEDIA] = LAYOUT(_______, _______, _______, _______, _______, _______),
-    [_CONFIG] = LAYOUT(DPI_CYCLE, DPI_CYCLE, _______, _______, _______, _______)
+    [_CONFIG] = LAYOUT(DPI_CYCLE, DPI_CYCLE, CFG_STATS, _______, _______, _______)
 };
 
 bool process_record_user(uint16_t keycode, keyrecord_t *record) {
@@ -164,93 +178,192 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         case DPI_CYCLE:
             if (record->event.pressed) {
                 current_dpi_index = (current_dpi_index + 1) % dpi_levels_count;
-                pointing_device_set_cpi(dpi_levels[current_dpi_index]);
+                sensor_cpi_set_base(dpi_levels[current_dpi_index]);
             }
             return false;
+#ifdef PIPELINE_TIMING_ENABLE
+        case PIPE_STATS:
+            if (record->event.pressed) print_pipeline_stats();
+            return false;
+#endif
+    }
+    return true;
+}
+
+static bool mode_active(void) {
+    return is_nav_mode || is_overview_mode || is_scroll_mode || IS_LAYER_ON(_MEDIA) || is_zoom_mode;
+}
+
+static bool frozen_enabled(void) { return cursor_frozen; }
+static bool nav_enabled(void) { return is_nav_mode; }
+static bool overview_enabled(void) { return is_overview_mode; }
+static bool scroll_enabled(void) { return is_scroll_mode; }
+static bool media_enabled(void) { return IS_LAYER_ON(_MEDIA); }
+static bool zoom_enabled(void) { return is_zoom_mode; }
+static bool coast_enabled(void) { return !is_scroll_mode; }
+
+static bool frozen_stage(report_mouse_t *r) {
+    subpixel_reset(&cursor_subpixel);
+    scroll_stop(&scroll_state);
+    r->x = 0;
+    r->y = 0;
+    r->v = 0;
+    r->h = 0;
+    return false;
+}
+
+static bool settle_stage(report_mouse_t *r) {
+    // Any motion outside drag-scroll cancels its momentum
+    if (!is_scroll_mode && (r->x != 0 || r->y != 0)) {
+        scroll_stop(&scroll_state);
+    }
+
+    // Leftover cursor motion must not leak out after a mode ends
+    if (mode_active()) {
+        subpixel_reset(&cursor_subpixel);
+    }
+    return true;
+}
+
+static bool nav_stage(report_mouse_t *r) {
+    gesture_t g = gesture_detect(&nav_gesture, r->x, r->y);
+    if (g == GESTURE_RIGHT) tap_code16(LGUI(KC_N));
+    else if (g == GESTURE_LEFT) tap_code16(LGUI(KC_P));
+    r->x = 0;
+    r->y = 0;
+    return true;
+}
+
+static bool overview_stage(report_mouse_t *r) {
+    gesture_t g = gesture_detect(&nav_gesture, r->x, r->y);
+    if (g == GESTURE_UP) tap_code16(LGUI(KC_TAB));
+    else if (g == GESTURE_DOWN) tap_code16(LGUI(LSFT(KC_TAB)));
+    r->x = 0;
+    r->y = 0;
+    return true;
+}
+
+static bool scroll_stage(report_mouse_t *r) {
+    int16_t sh, sv;
+    scroll_accumulate(&scroll_state, r->x, r->y);
+    scroll_coast(&scroll_state);
+    scroll_consume(&scroll_state, &sh, &sv, HV_REPORT_MAX);
+    r->h = (mouse_hv_report_t)sh;
+    r->v = (mouse_hv_report_t)sv;
+    r->x = 0;
+    r->y = 0;
+    return true;
+}
+
+static bool media_stage(report_mouse_t *r) {
+    gesture_t g = gesture_detect(&media_gesture, r->x, r->y);
+    if (g == GESTURE_UP) tap_code(KC_VOLU);
+    else if (g == GESTURE_DOWN) tap_code(KC_VOLD);
+    else if (g == GESTURE_RIGHT) tap_code(KC_BRIU);
+    else if (g == GESTURE_LEFT) tap_code(KC_BRID);
+    // Diagonals are tracks: up for next/previous, down for play/pause
+    else if (g == GESTURE_UP_RIGHT) tap_code(KC_MNXT);
+    else if (g == GESTURE_UP_LEFT) tap_code(KC_MPRV);
+    else if (g == GESTURE_DOWN_RIGHT || g == GESTURE_DOWN_LEFT) tap_code(KC_MPLY);
+    r->x = 0;
+    r->y = 0;
+    r->v = 0;
+    r->h = 0;
+    return true;
+}
+
+static bool zoom_stage(report_mouse_t *r) {
+    // One detent per count, in whatever units the wheel is reported in
+    int16_t zh, zv;
+    scroll_accumulate(&zoom_state, 0, r->y);
+    scroll_consume(&zoom_state, &zh, &zv, HV_REPORT_MAX);
+    r->v = (mouse_hv_report_t)zv;
+    r->x = 0;
+    r->y = 0;
+    r->h = 0;
+    return true;
+}
+
+static bool cursor_stage(report_mouse_t *r) {
+    int32_t qx, qy;
+    int16_t ax, ay;
+    cursor_accelerate_q8(r->x, r->y, &qx, &qy);
+    subpixel_add_q8(&cursor_subpixel, qx, qy);
+    subpixel_take(&cursor_subpixel, &ax, &ay, 127);
+    r->x = (mouse_xy_report_t)ax;
+    r->y = (mouse_xy_report_t)ay;
+    return true;
+}
+
+static bool coast_stage(report_mouse_t *r) {
+    if (scroll_coast(&scroll_state)) {
+        int16_t sh, sv;
+        scroll_consume(&scroll_state, &sh, &sv, HV_REPORT_MAX);
+        r->h = (mouse_hv_report_t)sh;
+        r->v = (mouse_hv_report_t)sv;
     }
     return true;
 }
 
+// Consumers are tried in order and the first enabled one takes the motion
+static const pipeline_stage_t pointing_stages[] = {
+    PIPELINE_STAGE("frozen",   PIPELINE_FILTER,    frozen_enabled,   frozen_stage),
+    PIPELINE_STAGE("settle",   PIPELINE_TRANSFORM, NULL,             settle_stage),
+    PIPELINE_STAGE("nav",      PIPELINE_CONSUME,   nav_enabled,      nav_stage),
+    PIPELINE_STAGE("overview", PIPELINE_CONSUME,   overview_enabled, overview_stage),
+    PIPELINE_STAGE("scroll",   PIPELINE_CONSUME,   scroll_enabled,   scroll_stage),
+    PIPELINE_STAGE("media",    PIPELINE_CONSUME,   media_enabled,    media_stage),
+    PIPELINE_STAGE("zoom",     PIPELINE_CONSUME,   zoom_enabled,     zoom_stage),
+    PIPELINE_STAGE("cursor",   PIPELINE_CONSUME,   NULL,             cursor_stage),
+    PIPELINE_STAGE("coast",    PIPELINE_TRANSFORM, coast_enabled,    coast_stage),
+};
+
+#ifdef PIPELINE_TIMING_ENABLE
+static void print_pipeline_stats(void) {
+    pipeline_stats_print(pointing_stages, PIPELINE_LENGTH(pointing_stages));
+    pipeline_stats_reset();
+    uprintf("SENSOR cpi writes %lu avoided %lu\n",
+            (unsigned long)sensor_cpi_writes(), (unsigned long)sensor_cpi_avoided());
+}
+#endif
+
 report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
     lockstate_task();
     
     lock_state_t s = lockstate_cached();
     if (lockstate_is_moonlander(s) || s == LOCK_STATE_IDLE) {
         cursor_frozen = (s == LOCK_STATE_ML_NUM);
+        // Runs every pass; the sensor shadow only writes on a change
         if (s == LOCK_STATE_IDLE) {
             gestures_disabled = false;
-            pointing_device_set_cpi(dpi_levels[current_dpi_index]);
+            sensor_cpi_release();
         } else if (s == LOCK_STATE_ML_NAV) {
-            pointing_device_set_cpi(400);
+            sensor_cpi_override(400);
         } else if (s == LOCK_STATE_ML_MACRO) {
             gestures_disabled = true;
         }
     }
     
-    if (cursor_frozen) {
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-        mouse_report.v = 0;
-        mouse_report.h = 0;
-        return mouse_report;
-    }
-    
-    if (is_nav_mode) {
-        gesture_t g = gesture_detect(&nav_gesture, mouse_report.x, mouse_report.y);
-        if (g == GESTURE_RIGHT) tap_code16(LGUI(KC_N));
-        else if (g == GESTURE_LEFT) tap_code16(LGUI(KC_P));
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-    } else if (is_overview_mode) {
-        gesture_t g = gesture_detect(&nav_gesture, mouse_report.x, mouse_report.y);
-        if (g == GESTURE_UP) tap_code16(LGUI(KC_TAB));
-        else if (g == GESTURE_DOWN) tap_code16(LGUI(LSFT(KC_TAB)));
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-    } else if (is_scroll_mode) {
-        scroll_accumulate(&scroll_state, mouse_report.x, mouse_report.y);
-        scroll_consume(&scroll_state, &mouse_report.h, &mouse_report.v);
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-    } else if (IS_LAYER_ON(_MEDIA)) {
-        gesture_t g = gesture_detect(&media_gesture, mouse_report.x, mouse_report.y);
-        if (g == GESTURE_UP) tap_code(KC_VOLU);
-        else if (g == GESTURE_DOWN) tap_code(KC_VOLD);
-        else if (g == GESTURE_RIGHT) tap_code(KC_BRIU);
-        else if (g == GESTURE_LEFT) tap_code(KC_BRID);
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-        mouse_report.v = 0;
-        mouse_report.h = 0;
-    } else if (is_zoom_mode) {
-        mouse_report.v = -mouse_report.y;
-        mouse_report.x = 0;
-        mouse_report.y = 0;
-        mouse_report.h = 0;
-    } else {
-        int16_t ax = mouse_report.x;
-        int16_t ay = mouse_report.y;
-        cursor_apply_acceleration(&ax, &ay);
-        if (ax > 127) ax = 127;
-        if (ax < -127) ax = -127;
-        if (ay > 127) ay = 127;
-        if (ay < -127) ay = -127;
-        mouse_report.x = (mouse_xy_report_t)ax;
-        mouse_report.y = (mouse_xy_report_t)ay;
-    }
-    
-    return mouse_report;
+    return pipeline_run(pointing_stages, PIPELINE_LENGTH(pointing_stages), mouse_report);
 }
 
 void keyboard_post_init_user(void) {
-    pointing_device_set_cpi(dpi_levels[current_dpi_index]);
-    gesture_init(&nav_gesture, 450, 300);
-    gesture_init(&media_gesture, 150, 0);
-    scroll_init(&scroll_state, 0.9f);
+    sensor_cpi_init(dpi_levels[current_dpi_index]);
+    gesture_init(&nav_gesture, 450, 300, false);
+    gesture_init(&media_gesture, 150, 0, true);
+    scroll_init(&scroll_state, SCROLL_SENSITIVITY_Q8, SCROLL_RESOLUTION);
+    scroll_init(&zoom_state, 256, SCROLL_RESOLUTION);
     cursor_init(&cursor_state, 400);
+    subpixel_init(&cursor_subpixel);
     lockstate_init(LOCK_ROLE_SECONDARY);
 }
 
+// Host LED report: queue it so the next pointing pass reacts without polling
+bool led_update_user(led_t led_state) {
+    lockstate_led_update(led_state.raw);
+    return true;
+}
+
 void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state) {
     (void)old_state; (void)new_state;
 }
@@ -259,7 +372,9 @@ void lockstate_on_sync_request(void) {
     cursor_frozen = false;
     gestures_disabled = false;
     is_scroll_mode = false;
+    scroll_stop(&scroll_state);
     is_zoom_mode = false;
     if (IS_LAYER_ON(_MEDIA)) layer_off(_MEDIA);
-    pointing_device_set_cpi(dpi_levels[current_dpi_index]);
+    sensor_cpi_invalidate();
+    sensor_cpi_release();
 }
@@ -6,9 +6,17 @@ COMBO_ENABLE = yes
 VIA_ENABLE = no
 PLOOPY_DRAGSCROLL_ENABLE = no
 LTO_ENABLE = yes
+PIPELINE_TIMING_ENABLE = no
 
 SRC += lib/ipc/lockstate.c
 SRC += lib/pointing/gestures.c
 SRC += lib/pointing/accumulators.c
 SRC += lib/pointing/cursor.c
 SRC += lib/pointing/scroll.c
+SRC += lib/pointing/subpixel.c
+SRC += lib/pointing/pipeline.c
+SRC += lib/pointing/sensor.c
+
+ifeq ($(strip $(PIPELINE_TIMING_ENABLE)), yes)
+    OPT_DEFS += -DPIPELINE_TIMING_ENABLE
+endif
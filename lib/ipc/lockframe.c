@@ -0,0 +1,145 @@
+#include "lockframe.h"
+#include QMK_KEYBOARD_H
+#include <string.h>
+
+typedef enum {
+    LF_IDLE,
+    LF_SEND,
+    LF_RESTORE,  // Sender writing back its starting state, then idling
+} lf_mode_t;
+
+static struct {
+    lf_mode_t mode;  // Sender only; the receiver has its own
+
+    uint8_t      tx[LOCKFRAME_BYTES];
+    uint8_t      tx_bytes;
+    uint8_t      tx_symbol;
+    uint8_t      tx_seq;
+    bool         tx_closed;
+    lock_state_t tx_target;
+    lock_state_t tx_resume;
+    uint16_t     tx_time;
+
+    lockframe_rx_t rx;
+} lf;
+
+static lockframe_stats_t stats;
+
+void lockframe_init(void) {
+    memset(&lf, 0, sizeof(lf));
+    lf.mode = LF_IDLE;
+    lockframe_rx_init(&lf.rx, &stats);
+    lockframe_stats_reset();
+}
+
+bool lockframe_busy(void) {
+    return lf.mode != LF_IDLE || lf.rx.mode != LF_RX_IDLE;
+}
+
+const lockframe_stats_t *lockframe_stats(void) {
+    return &stats;
+}
+
+void lockframe_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// ---------------------------------------------------------------------------
+// Sender
+// ---------------------------------------------------------------------------
+
+static void tx_write(lock_state_t state) {
+    lf.tx_target = state;
+    lf.tx_time = timer_read();
+    lockstate_write(state);
+}
+
+static void tx_restore(void) {
+    lf.mode = LF_RESTORE;
+    tx_write(lf.tx_resume);
+}
+
+bool lockframe_send(uint8_t type, const uint8_t *payload, uint8_t len) {
+    if (lockframe_busy() || len > LOCKFRAME_MAX_PAYLOAD || lockstate.sync_requested) return false;
+    lf.tx_resume = lockstate_get();
+    if (lf.tx_resume == LOCK_STATE_SYNC_REQ) return false;
+
+    lf.tx_seq = (lf.tx_seq + 1) & 0x0F;
+    lf.tx[0] = (uint8_t)(lf.tx_seq << 4) | (type & 0x0F);
+    lf.tx[1] = len;
+    if (len) memcpy(&lf.tx[2], payload, len);
+    lf.tx[2 + len] = lockframe_crc8(lf.tx, 2 + len);
+    lf.tx_bytes = len + LOCKFRAME_OVERHEAD;
+    lf.tx_symbol = 0;
+    lf.tx_closed = false;
+
+    lf.mode = LF_SEND;
+    tx_write(LOCK_STATE_SYNC_REQ);
+    return true;
+}
+
+// One symbol per completed write, so the receiver sees every clock edge
+static void tx_step(void) {
+    if (lockstate_get() != lf.tx_target) {
+        if (!lockstate_writing()) {
+            stats.aborted++;
+            tx_restore();
+        }
+        return;
+    }
+
+    if (lf.tx_symbol < lf.tx_bytes * 4) {
+        uint8_t byte = lf.tx[lf.tx_symbol / 4];
+        uint8_t data = (byte >> (6 - 2 * (lf.tx_symbol % 4))) & LOCKFRAME_DATA;
+        lf.tx_symbol++;
+        tx_write((lock_state_t)(((lf.tx_target & LOCKFRAME_CLOCK) ^ LOCKFRAME_CLOCK) | data));
+    } else if (!lf.tx_closed) {
+        // Clearing only drops bits, so the close never passes through 111
+        lf.tx_closed = true;
+        tx_write(LOCK_STATE_IDLE);
+    } else {
+        stats.sent++;
+        tx_restore();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Receiver
+// ---------------------------------------------------------------------------
+
+// Sees every LED state before lockstate does, from both the LED report
+// hook and the fallback poll; a frame we are sending is never decoded
+bool lockstate_intercept(lock_state_t state) {
+    switch (lf.mode) {
+        case LF_SEND:
+            return true;
+        case LF_RESTORE:
+            return false;
+        default:
+            return lockframe_rx_feed(&lf.rx, state, lockstate.sync_requested);
+    }
+}
+
+void lockframe_task(void) {
+    switch (lf.mode) {
+        case LF_SEND:
+            tx_step();
+            break;
+
+        case LF_RESTORE:
+            // The gap starts once the last restore toggle is echoed
+            if (lockstate_writing()) {
+                lf.tx_time = timer_read();
+            } else if (timer_elapsed(lf.tx_time) >= LOCKFRAME_IDLE_MS) {
+                lf.mode = LF_IDLE;
+            }
+            break;
+
+        default:
+            // Hand the LEDs back to lockstate and let it look at them afresh
+            if (lockframe_rx_expired(&lf.rx, lockstate_get())) {
+                lockstate_led_update(lockstate_get());
+            }
+            break;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "lockstate.h"
+#include "lockframe_rx.h"
+
+// Multi-byte messages over the lock LEDs, layered on lockstate. The wire
+// format and the decoder live in lockframe_rx; this adds the sender.
+//
+// lockstate_write() toggles scroll lock last, so data is always in place
+// before its edge. A frame closes by clearing the LEDs to 000 before the
+// sender restores the previous 3-bit state. A 111 held longer than
+// LOCKFRAME_IDLE_MS is handed back to lockstate as a real SYNC_REQ, so the
+// 3-bit states stay the fast path.
+//
+// No clock edge for LOCKFRAME_IDLE_MS means the line is idle: a receiver
+// drops whatever it had, and a sender keeps that gap after every frame so
+// a receiver that lost sync always gets back in step by the next one.
+//
+// Library-only for now: the Moonlander links no lockstate, so no firmware
+// has a peer to send to or receive from. Linking the receiver into a
+// keymap alone would only delay every real SYNC_REQ by LOCKFRAME_IDLE_MS.
+
+// A symbol is up to three taps, each normally echoed within
+// LOCKSTATE_ECHO_TIMEOUT and released within LOCKSTATE_TAP_MS. A host
+// slower than that stalls the sender past the idle gap, and the receiver
+// drops the frame as a timeout.
+_Static_assert(3 * (LOCKSTATE_ECHO_TIMEOUT + LOCKSTATE_TAP_MS) < LOCKFRAME_IDLE_MS,
+               "a sender waiting on its taps must not look idle to the receiver");
+
+void lockframe_init(void);
+// Queue a frame; false when busy, mid-receive, syncing or too long
+bool lockframe_send(uint8_t type, const uint8_t *payload, uint8_t len);
+bool lockframe_busy(void);
+// Call next to lockstate_task(); drives the sender and receiver timeouts
+void lockframe_task(void);
+const lockframe_stats_t *lockframe_stats(void);
+void lockframe_stats_reset(void);
@@ -0,0 +1,120 @@
+#include "lockframe_rx.h"
+#include QMK_KEYBOARD_H
+#include <string.h>
+
+#define LEDS_SYNC 0b111
+#define LEDS_IDLE 0b000
+
+uint8_t lockframe_crc8(const uint8_t *data, uint8_t len) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+__attribute__((weak)) void lockframe_on_receive(uint8_t type, const uint8_t *payload, uint8_t len) {
+    (void)type; (void)payload; (void)len;
+}
+
+void lockframe_rx_init(lockframe_rx_t *rx, lockframe_stats_t *stats) {
+    memset(rx, 0, sizeof(*rx));
+    rx->mode = LF_RX_IDLE;
+    rx->stats = stats;
+}
+
+static void rx_complete(lockframe_rx_t *rx) {
+    uint8_t len = rx->buf[1];
+    if (lockframe_crc8(rx->buf, 2 + len) != rx->buf[2 + len]) {
+        rx->stats->bad_checksum++;
+        return;
+    }
+
+    uint8_t seq = rx->buf[0] >> 4;
+    if (rx->have_seq) {
+        if (seq == rx->seq) {
+            rx->stats->duplicates++;
+            return;
+        }
+        rx->stats->seq_gaps += (seq - rx->seq - 1) & 0x0F;
+    }
+    rx->seq = seq;
+    rx->have_seq = true;
+
+    rx->stats->received++;
+    lockframe_on_receive(rx->buf[0] & 0x0F, &rx->buf[2], len);
+}
+
+static void rx_symbol(lockframe_rx_t *rx, uint8_t data) {
+    rx->byte = (uint8_t)(rx->byte << 2) | data;
+    if (++rx->symbols < 4) return;
+
+    rx->buf[rx->bytes++] = rx->byte;
+    rx->symbols = 0;
+    rx->byte = 0;
+
+    if (rx->bytes == 2 && rx->buf[1] > LOCKFRAME_MAX_PAYLOAD) {
+        rx->stats->bad_length++;
+        rx->mode = LF_RX_DISCARD;
+    } else if (rx->bytes >= 2 && rx->bytes == rx->buf[1] + LOCKFRAME_OVERHEAD) {
+        rx_complete(rx);
+        // A last symbol of 00 with the clock low already is the close
+        rx->mode = rx->last == LEDS_IDLE ? LF_RX_IDLE : LF_RX_CLOSING;
+    }
+}
+
+bool lockframe_rx_feed(lockframe_rx_t *rx, uint8_t leds, bool sync_requested) {
+    leds &= 0b111;
+
+    switch (rx->mode) {
+        case LF_RX_IDLE:
+            if (leds != LEDS_SYNC) {
+                rx->passthrough = false;
+                return false;
+            }
+            if (rx->passthrough || sync_requested) return false;
+            rx->mode = LF_RX_ESCAPE;
+            rx->last = leds;
+            rx->time = timer_read();
+            rx->bytes = 0;
+            rx->symbols = 0;
+            rx->byte = 0;
+            return true;
+
+        case LF_RX_CLOSING:
+            rx->last = leds;
+            rx->time = timer_read();
+            if (leds == LEDS_IDLE) rx->mode = LF_RX_IDLE;
+            return true;
+
+        default:
+            break;
+    }
+
+    bool edge = (leds ^ rx->last) & LOCKFRAME_CLOCK;
+    rx->last = leds;
+    if (!edge) return true;
+
+    rx->time = timer_read();
+    if (rx->mode != LF_RX_DISCARD) {
+        rx->mode = LF_RX_RECEIVE;
+        rx_symbol(rx, leds & LOCKFRAME_DATA);
+    }
+    return true;
+}
+
+bool lockframe_rx_expired(lockframe_rx_t *rx, uint8_t leds) {
+    if (rx->mode == LF_RX_IDLE || timer_elapsed(rx->time) < LOCKFRAME_IDLE_MS) return false;
+
+    if (rx->mode == LF_RX_ESCAPE) {
+        // No edge followed: the 111 was a real sync request
+        rx->passthrough = (leds & 0b111) == LEDS_SYNC;
+    } else if (rx->mode == LF_RX_RECEIVE) {
+        rx->stats->timeouts++;
+    }
+    rx->mode = LF_RX_IDLE;
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Lockframe wire format and decoder, shared by every lockstate that
+// receives frames: lib/ipc/lockframe and shared/lockstate/lockframe. It
+// only sees 3-bit LED states, so it has no lockstate dependency; each
+// front end feeds it from its own lockstate_intercept() and hands the
+// LEDs back to its own lockstate once the line goes idle.
+//
+//   [seq:4 | type:4] [len] [payload: len bytes] [crc8]
+//
+// Each byte goes out MSB first as four 2-bit symbols: Num and Caps are
+// the data, sampled on every Scroll Lock edge. A frame opens with 111 and
+// an edge within LOCKFRAME_IDLE_MS, and closes with 000; a 111 held longer
+// is a real SYNC_REQ and is passed through.
+
+#ifndef LOCKFRAME_MAX_PAYLOAD
+#define LOCKFRAME_MAX_PAYLOAD 8
+#endif
+
+#ifndef LOCKFRAME_IDLE_MS
+#define LOCKFRAME_IDLE_MS 50  // Quiet line between frames
+#endif
+
+#define LOCKFRAME_CLOCK 0b100
+#define LOCKFRAME_DATA  0b011
+#define LOCKFRAME_OVERHEAD 3
+#define LOCKFRAME_BYTES (LOCKFRAME_MAX_PAYLOAD + LOCKFRAME_OVERHEAD)
+
+// Types are 4 bits; values not listed here are free for keymaps
+typedef enum {
+    LOCKFRAME_LAYERS  = 1,  // layer_state_t, little endian
+    LOCKFRAME_DPI     = 2,  // uint16_t CPI, little endian
+    LOCKFRAME_COUNTER = 3,  // int32_t, little endian
+} lockframe_type_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t aborted;       // Write abandoned: no echo, or a toggle it did not make
+    uint32_t received;
+    uint32_t bad_checksum;
+    uint32_t bad_length;
+    uint32_t duplicates;
+    uint32_t seq_gaps;      // Frames missed between two received ones
+    uint32_t timeouts;      // Line went idle mid-frame
+} lockframe_stats_t;
+
+typedef enum {
+    LF_RX_IDLE,
+    LF_RX_ESCAPE,   // Saw 111; a frame if an edge follows, else a sync request
+    LF_RX_RECEIVE,
+    LF_RX_DISCARD,  // Bad header; swallow the rest until the line is idle
+    LF_RX_CLOSING,  // Frame complete; waiting for the sender's 000
+} lockframe_rx_mode_t;
+
+typedef struct {
+    lockframe_rx_mode_t mode;
+    uint8_t  buf[LOCKFRAME_BYTES];
+    uint8_t  bytes;
+    uint8_t  symbols;
+    uint8_t  byte;
+    uint8_t  seq;
+    bool     have_seq;
+    bool     passthrough;  // Current 111 is a real SYNC_REQ
+    uint8_t  last;
+    uint16_t time;
+    lockframe_stats_t *stats;
+} lockframe_rx_t;
+
+void lockframe_rx_init(lockframe_rx_t *rx, lockframe_stats_t *stats);
+// Feed every LED state, repeats included; true while it belongs to a
+// frame and must be hidden from lockstate. sync_requested is the local
+// lockstate's own SYNC_REQ, which is never a frame.
+bool lockframe_rx_feed(lockframe_rx_t *rx, uint8_t leds, bool sync_requested);
+// Call every task with the current LEDs; true once the line has been idle
+// for LOCKFRAME_IDLE_MS mid-frame, when the LEDs go back to lockstate
+bool lockframe_rx_expired(lockframe_rx_t *rx, uint8_t leds);
+
+// Called once per good frame; weak default ignores it
+void lockframe_on_receive(uint8_t type, const uint8_t *payload, uint8_t len);
+
+uint8_t lockframe_crc8(const uint8_t *data, uint8_t len);
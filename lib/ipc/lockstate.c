@@ -10,7 +10,19 @@ lockstate_state_t lockstate = {
     .role = LOCK_ROLE_PRIMARY,
     .last_change_time = 0,
     .last_poll_time = 0,
-    .sync_requested = false
+    .event_time = 0,
+    .write_time = 0,
+    .write_target = LOCK_STATE_IDLE,
+    .write_prev = LOCK_STATE_IDLE,
+    .write_expect = LOCK_STATE_IDLE,
+    .write_held = KC_NO,
+    .echo_ms = 0,
+    .writing = false,
+    .sync_requested = false,
+    .event_pending = false,
+    .events_seen = false,
+    .write_failures = 0,
+    .write_late = 0
 };
 
 void lockstate_init(lock_role_t role) {
@@ -19,6 +31,14 @@ void lockstate_init(lock_role_t role) {
     lockstate.last_change_time = timer_read();
     lockstate.last_poll_time = timer_read();
     lockstate.sync_requested = false;
+    lockstate.event_pending = false;
+    lockstate.events_seen = false;
+    lockstate.echo_ms = 0;
+    if (lockstate.write_held) {
+        unregister_code(lockstate.write_held);
+        lockstate.write_held = KC_NO;
+    }
+    lockstate.writing = false;
     lockstate_set(LOCK_STATE_IDLE);
 #ifdef LOGGING_ENABLE
     LOG_INFO("Lock state init: role=%s", 
@@ -38,15 +58,7 @@ void lockstate_set(lock_state_t state) {
     lock_state_t old_state = lockstate.cached_state;
 #endif
 
-    // We cannot directly set host LED state in QMK; instead, toggle host locks
-    // by emitting the lock keycodes until the bitmask matches.
-    lock_state_t current = lockstate_get();
-    uint8_t diff = ((uint8_t)current) ^ ((uint8_t)state);
-
-    if (diff & 0b001) tap_code(KC_NUM_LOCK);
-    if (diff & 0b010) tap_code(KC_CAPS_LOCK);
-    if (diff & 0b100) tap_code(KC_SCROLL_LOCK);
-
+    lockstate_write(state);
     lockstate.cached_state = state;
     lockstate.last_change_time = timer_read();
 
@@ -56,6 +68,81 @@ void lockstate_set(lock_state_t state) {
 
 }
 
+// We cannot directly set host LED state in QMK; instead, toggle host locks
+// by emitting the lock keycodes until the bitmask matches. One key press per
+// call, released on the next, and only once the previous one has been
+// echoed, so a write never stalls the caller or races its own echoes. Num
+// lock goes first and scroll lock last, which lockframe relies on for its
+// clock.
+static void lockstate_write_step(void) {
+    // The host toggles on the press; the release only ends the tap
+    if (lockstate.write_held) {
+        unregister_code(lockstate.write_held);
+        lockstate.write_held = KC_NO;
+    }
+
+    lock_state_t current = lockstate_get();
+    uint16_t waited = timer_elapsed(lockstate.write_time);
+
+    if (current != lockstate.write_expect) {
+        if (current == lockstate.write_prev && waited < LOCKSTATE_ECHO_LOST) {
+            return;  // Echo still on its way, however slow
+        }
+        // Never echoed, or someone else toggled a lock: give up and let
+        // the conflict check sort out what the LEDs should be
+#ifdef LOGGING_ENABLE
+        LOG_WARN("Lock write to %s abandoned at %s",
+                 lockstate_name(lockstate.write_target), lockstate_name(current));
+#endif
+        lockstate.writing = false;
+        lockstate.write_failures++;
+        return;
+    }
+
+    // Echo of the tap in flight: track the slowest, letting it decay
+    if (lockstate.write_prev != lockstate.write_expect) {
+        uint8_t echo = waited > UINT8_MAX ? UINT8_MAX : waited;
+        if (waited >= LOCKSTATE_ECHO_TIMEOUT) lockstate.write_late++;
+        if (echo >= lockstate.echo_ms) {
+            lockstate.echo_ms = echo;
+        } else {
+            lockstate.echo_ms -= (lockstate.echo_ms - echo + 3) / 4;
+        }
+        lockstate.write_prev = current;
+    }
+
+    uint8_t diff = ((uint8_t)current) ^ ((uint8_t)lockstate.write_target);
+    if (!diff) {
+        lockstate.writing = false;
+        return;
+    }
+
+    uint8_t bit = diff & -diff;
+    lockstate.write_prev = current;
+    lockstate.write_expect = (lock_state_t)(current ^ bit);
+    lockstate.write_time = timer_read();
+    lockstate.write_held = bit == 0b001 ? KC_NUM_LOCK : bit == 0b010 ? KC_CAPS_LOCK : KC_SCROLL_LOCK;
+    register_code(lockstate.write_held);
+}
+
+void lockstate_write(lock_state_t state) {
+    if (!lockstate.writing) {
+        lockstate.write_prev = lockstate.write_expect = lockstate_get();
+        lockstate.writing = true;
+    }
+    lockstate.write_target = state;
+    lockstate_write_step();
+}
+
+bool lockstate_writing(void) {
+    return lockstate.writing;
+}
+
+uint16_t lockstate_settle_ms(void) {
+    uint16_t settle = lockstate.echo_ms + lockstate.echo_ms / 2;
+    return settle > LOCKSTATE_EVENT_SETTLE ? settle : LOCKSTATE_EVENT_SETTLE;
+}
+
 lock_state_t lockstate_get(void) {
     led_t led_state = host_keyboard_led_state();
     uint8_t state = 0;
@@ -78,11 +165,7 @@ bool lockstate_is_owned(lock_state_t state) {
     }
 }
 
-void lockstate_task(void) {
-    if (timer_elapsed(lockstate.last_poll_time) < LOCKSTATE_POLL_INTERVAL) return;
-    lockstate.last_poll_time = timer_read();
-    
-    lock_state_t current_state = lockstate_get();
+static void lockstate_process(lock_state_t current_state) {
     lock_state_t cached_state = lockstate.cached_state;
     
     if (current_state == LOCK_STATE_SYNC_REQ) {
@@ -123,6 +206,40 @@ void lockstate_task(void) {
     }
 }
 
+void lockstate_led_update(uint8_t leds) {
+    lockstate.events_seen = true;
+    if (lockstate_intercept((lock_state_t)(leds & 0b111))) {
+        lockstate.event_pending = false;
+        return;
+    }
+    lockstate.event_time = timer_read();
+    lockstate.event_pending = true;
+}
+
+void lockstate_task(void) {
+    // Half-applied writes are never judged; events wait until it lands
+    if (lockstate.writing) {
+        lockstate_write_step();
+        if (lockstate.writing) return;
+    }
+
+    if (lockstate.event_pending) {
+        if (timer_elapsed(lockstate.event_time) < lockstate_settle_ms()) return;
+        lockstate.event_pending = false;
+    } else {
+        // A held SYNC_REQ still needs its regular release check
+        uint16_t interval = lockstate.events_seen && !lockstate.sync_requested
+                          ? LOCKSTATE_FALLBACK_INTERVAL : LOCKSTATE_POLL_INTERVAL;
+        if (timer_elapsed(lockstate.last_poll_time) < interval) return;
+    }
+    lockstate.last_poll_time = timer_read();
+
+    // Asked again at handling time: a frame may have started since the event
+    lock_state_t current_state = lockstate_get();
+    if (lockstate_intercept(current_state)) return;
+    lockstate_process(current_state);
+}
+
 void lockstate_sync_request(void) {
 #ifdef LOGGING_ENABLE
     LOG_WARN("Requesting emergency sync");
@@ -155,6 +272,12 @@ __attribute__((weak)) void lockstate_on_remote_change(lock_state_t old_state, lo
 
 __attribute__((weak)) void lockstate_on_sync_request(void) {}
 
+// Overridden by a layer that borrows the LEDs, such as lockframe
+__attribute__((weak)) bool lockstate_intercept(lock_state_t state) {
+    (void)state;
+    return false;
+}
+
 #ifdef LOGGING_ENABLE
 void lockstate_log_change(lock_state_t old_state, lock_state_t new_state) {
     if (old_state != new_state) {
@@ -30,20 +30,74 @@ typedef enum {
 #define LOCKSTATE_SYNC_HOLD 1000
 #endif
 
+// Once lockstate_led_update() is wired up, polling only backs it up
+#ifndef LOCKSTATE_FALLBACK_INTERVAL
+#define LOCKSTATE_FALLBACK_INTERVAL 500
+#endif
+
+// A multi-lock write echoes one LED at a time; wait this long for the
+// report to settle so intermediate states are never acted on. The peer's
+// taps are one echo apart, so the settle grows to 1.5x the slowest echo
+// this device has seen (see lockstate_settle_ms()).
+#ifndef LOCKSTATE_EVENT_SETTLE
+#define LOCKSTATE_EVENT_SETTLE 4
+#endif
+
+// Writes are one lock key press per lockstate_task(), released on the next
+// call and each waiting for its host echo, which normally lands within
+// LOCKSTATE_ECHO_TIMEOUT. Past that the echo is late, not lost: pressing
+// again would toggle the lock back once it lands, so the write keeps
+// waiting for the LEDs to leave their old state and only gives up after
+// LOCKSTATE_ECHO_LOST. Never tap_code(): QMK holds Caps Lock for
+// TAP_HOLD_CAPS_DELAY (80 ms) inside it, stalling the whole scan.
+#ifndef LOCKSTATE_ECHO_TIMEOUT
+#define LOCKSTATE_ECHO_TIMEOUT 12
+#endif
+
+#ifndef LOCKSTATE_ECHO_LOST
+#define LOCKSTATE_ECHO_LOST 100
+#endif
+
+// Longest a lock key keeps the engine busy beyond its echo: the release
+// goes out on the next lockstate_task(), one scan later
+#ifndef LOCKSTATE_TAP_MS
+#define LOCKSTATE_TAP_MS 2
+#endif
+
 typedef struct {
     lock_state_t cached_state;
     lock_role_t role;
     uint16_t last_change_time;
     uint16_t last_poll_time;
+    uint16_t event_time;
+    uint16_t write_time;
+    lock_state_t write_target;
+    lock_state_t write_prev;    // LEDs before the tap in flight
+    lock_state_t write_expect;  // LEDs once it is echoed
+    uint8_t write_held;         // Lock key pressed last step, or KC_NO
+    uint8_t echo_ms;            // Slowest recent echo, decaying
+    bool writing;
     bool sync_requested;
+    bool event_pending;
+    bool events_seen;
+    uint16_t write_failures;
+    uint16_t write_late;        // Echoes past LOCKSTATE_ECHO_TIMEOUT
 } lockstate_state_t;
 
 extern lockstate_state_t lockstate;
 
 void lockstate_init(lock_role_t role);
 void lockstate_set(lock_state_t state);
+// Raw LED write: no ownership check, cache untouched. Starts the toggle
+// engine, which finishes from lockstate_task()
+void lockstate_write(lock_state_t state);
+bool lockstate_writing(void);
+// Quiet time before an LED event is acted on, scaled to the echo latency
+uint16_t lockstate_settle_ms(void);
 lock_state_t lockstate_get(void);
 void lockstate_task(void);
+// Call from led_update_user() with led_state.raw; bits 0-2 are the encoding
+void lockstate_led_update(uint8_t leds);
 lock_state_t lockstate_cached(void);
 bool lockstate_is_owned(lock_state_t state);
 void lockstate_sync_request(void);
@@ -60,6 +114,8 @@ static inline bool lockstate_is_ploopy(lock_state_t s) {
 
 void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state);
 void lockstate_on_sync_request(void);
+// Sees every host LED state first; return true to hide it from lockstate
+bool lockstate_intercept(lock_state_t state);
 
 #ifdef LOGGING_ENABLE
 void lockstate_log_change(lock_state_t old_state, lock_state_t new_state);
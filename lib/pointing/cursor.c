@@ -1,22 +1,59 @@
 #include "cursor.h"
+#include "sensor.h"
 #include QMK_KEYBOARD_H
-#include <math.h>
+
+// Entry i covers squared speeds [i, i + 1) * 16 and is sampled at the middle;
+// __builtin_sqrt folds to a constant, so no float math reaches the firmware
+#define GAIN(i) CURSOR_GAIN_Q8(__builtin_sqrt(((i) + 0.5) * (1 << CURSOR_GAIN_SQ_SHIFT)))
+#define GAIN_ROW(r) \
+    GAIN(r * 16 + 0),  GAIN(r * 16 + 1),  GAIN(r * 16 + 2),  GAIN(r * 16 + 3), \
+    GAIN(r * 16 + 4),  GAIN(r * 16 + 5),  GAIN(r * 16 + 6),  GAIN(r * 16 + 7), \
+    GAIN(r * 16 + 8),  GAIN(r * 16 + 9),  GAIN(r * 16 + 10), GAIN(r * 16 + 11), \
+    GAIN(r * 16 + 12), GAIN(r * 16 + 13), GAIN(r * 16 + 14), GAIN(r * 16 + 15)
+
+static const uint16_t gain_table[CURSOR_GAIN_STEPS] = {
+    GAIN_ROW(0),  GAIN_ROW(1),  GAIN_ROW(2),  GAIN_ROW(3),
+    GAIN_ROW(4),  GAIN_ROW(5),  GAIN_ROW(6),  GAIN_ROW(7),
+    GAIN_ROW(8),  GAIN_ROW(9),  GAIN_ROW(10), GAIN_ROW(11),
+    GAIN_ROW(12), GAIN_ROW(13), GAIN_ROW(14), GAIN_ROW(15),
+};
+
+_Static_assert(CURSOR_GAIN_STEPS == 16 * 16, "gain_table rows out of sync with CURSOR_GAIN_STEPS");
+
+static int16_t apply_gain(int16_t v, uint16_t gain) {
+    // Division truncates toward zero like the old float cast
+    int32_t out = ((int32_t)v * gain) / 256;
+    if (out > INT16_MAX) return INT16_MAX;
+    if (out < -INT16_MAX) return -INT16_MAX;
+    return (int16_t)out;
+}
+
+uint16_t cursor_gain_q8(int16_t x, int16_t y) {
+    uint32_t speed_sq = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y);
+    if (speed_sq >= CURSOR_GAIN_MAX_SPEED_SQ) {
+        return gain_table[CURSOR_GAIN_STEPS - 1];
+    }
+    return gain_table[speed_sq >> CURSOR_GAIN_SQ_SHIFT];
+}
 
 void cursor_init(cursor_state_t *state, uint16_t precision_dpi) {
     state->frozen = false;
     state->precision_mode = false;
-    state->saved_dpi = 0;
     state->precision_dpi = precision_dpi;
 }
 
 void cursor_apply_acceleration(int16_t *x, int16_t *y) {
-    float speed = sqrtf((float)(*x) * (float)(*x) + (float)(*y) * (float)(*y));
-    if (speed > CURSOR_ACCEL_OFFSET) {
-        float factor = 1.0f + powf(speed - CURSOR_ACCEL_OFFSET, 2) * 0.001f * CURSOR_ACCEL_SLOPE;
-        if (factor > CURSOR_ACCEL_LIMIT) factor = CURSOR_ACCEL_LIMIT;
-        *x = (int16_t)((float)(*x) * factor);
-        *y = (int16_t)((float)(*y) * factor);
-    }
+    uint16_t gain = cursor_gain_q8(*x, *y);
+    if (gain == 256) return;
+    *x = apply_gain(*x, gain);
+    *y = apply_gain(*y, gain);
+}
+
+// Unrounded Q8.8 output for a subpixel stage to carry
+void cursor_accelerate_q8(int16_t x, int16_t y, int32_t *x_q8, int32_t *y_q8) {
+    uint16_t gain = cursor_gain_q8(x, y);
+    *x_q8 = (int32_t)x * gain;
+    *y_q8 = (int32_t)y * gain;
 }
 
 void cursor_freeze(cursor_state_t *state) {
@@ -27,13 +64,13 @@ void cursor_unfreeze(cursor_state_t *state) {
     state->frozen = false;
 }
 
-void cursor_set_precision(cursor_state_t *state, bool enable, uint16_t current_dpi) {
+// The user's base CPI stays in the sensor shadow, so nothing is saved here
+void cursor_set_precision(cursor_state_t *state, bool enable) {
     if (enable && !state->precision_mode) {
-        state->saved_dpi = current_dpi;
-        pointing_device_set_cpi(state->precision_dpi);
+        sensor_cpi_override(state->precision_dpi);
         state->precision_mode = true;
     } else if (!enable && state->precision_mode) {
-        pointing_device_set_cpi(state->saved_dpi);
+        sensor_cpi_release();
         state->precision_mode = false;
     }
 }
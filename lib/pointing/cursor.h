@@ -14,17 +14,33 @@
 #define CURSOR_ACCEL_LIMIT 4.0
 #endif
 
+// Q8.8 gain table indexed by squared speed / 16, built from the constants above
+#define CURSOR_GAIN_SQ_SHIFT 4
+#define CURSOR_GAIN_STEPS 256
+#define CURSOR_GAIN_MAX_SPEED_SQ ((uint32_t)CURSOR_GAIN_STEPS << CURSOR_GAIN_SQ_SHIFT)
+
+// Float curve, only ever evaluated by the compiler
+#define CURSOR_GAIN_CURVE(speed) \
+    ((speed) <= CURSOR_ACCEL_OFFSET ? 1.0 : \
+     1.0 + ((speed) - CURSOR_ACCEL_OFFSET) * ((speed) - CURSOR_ACCEL_OFFSET) * 0.001 * CURSOR_ACCEL_SLOPE)
+#define CURSOR_GAIN_Q8(speed) \
+    ((uint16_t)((CURSOR_GAIN_CURVE(speed) < CURSOR_ACCEL_LIMIT ? CURSOR_GAIN_CURVE(speed) : CURSOR_ACCEL_LIMIT) * 256.0 + 0.5))
+
+_Static_assert(CURSOR_GAIN_CURVE(__builtin_sqrt(CURSOR_GAIN_MAX_SPEED_SQ)) >= CURSOR_ACCEL_LIMIT,
+               "cursor gain table ends before CURSOR_ACCEL_LIMIT is reached");
+
 typedef struct {
     bool frozen;
     bool precision_mode;
-    uint16_t saved_dpi;
     uint16_t precision_dpi;
 } cursor_state_t;
 
 void cursor_init(cursor_state_t *state, uint16_t precision_dpi);
+uint16_t cursor_gain_q8(int16_t x, int16_t y);
 void cursor_apply_acceleration(int16_t *x, int16_t *y);
+void cursor_accelerate_q8(int16_t x, int16_t y, int32_t *x_q8, int32_t *y_q8);
 void cursor_freeze(cursor_state_t *state);
 void cursor_unfreeze(cursor_state_t *state);
-void cursor_set_precision(cursor_state_t *state, bool enable, uint16_t current_dpi);
+void cursor_set_precision(cursor_state_t *state, bool enable);
 bool cursor_is_frozen(cursor_state_t *state);
 bool cursor_is_precision(cursor_state_t *state);
@@ -1,34 +1,148 @@
 #include "gestures.h"
 #include QMK_KEYBOARD_H
-#include <stdlib.h>
 
-void gesture_init(gesture_detector_t *det, int16_t threshold, uint16_t cooldown) {
-    accumulator_init(&det->acc);
+#define SAMPLE_MASK (GESTURE_SAMPLES - 1)
+
+// tan(22.5 deg) in Q8: a minor axis below this ratio is a cardinal stroke
+#define OCTANT_TAN_Q8 106
+
+static int32_t abs32(int32_t v) {
+    return v < 0 ? -v : v;
+}
+
+// Octagonal approximation of the vector length, within ~8%
+static int32_t norm(int32_t x, int32_t y) {
+    int32_t ax = abs32(x), ay = abs32(y);
+    int32_t hi = ax > ay ? ax : ay;
+    int32_t lo = ax > ay ? ay : ax;
+    return hi + lo / 2 - lo / 8;
+}
+
+// Leak 1/2^SHIFT per elapsed ms, always making progress toward zero
+static int32_t decay_axis(int32_t v, uint16_t ms) {
+    while (ms-- && v != 0) {
+        int32_t d = v / (1L << GESTURE_DECAY_SHIFT);
+        if (d == 0) d = (v > 0) - (v < 0);
+        v -= d;
+    }
+    return v;
+}
+
+static int32_t clamp_drift(int32_t v) {
+    if (v > (INT16_MAX * 256L)) return INT16_MAX * 256L;
+    if (v < -(INT16_MAX * 256L)) return -(INT16_MAX * 256L);
+    return v;
+}
+
+static void decay(gesture_detector_t *det, uint16_t now) {
+    uint16_t elapsed = (uint16_t)(now - det->last_decay);
+    det->last_decay = now;
+    if (elapsed >= (4U << GESTURE_DECAY_SHIFT)) {
+        det->drift_x = 0;
+        det->drift_y = 0;
+        return;
+    }
+    det->drift_x = decay_axis(det->drift_x, elapsed);
+    det->drift_y = decay_axis(det->drift_y, elapsed);
+}
+
+static void record_sample(gesture_detector_t *det, int16_t dx, int16_t dy, uint16_t now) {
+    gesture_sample_t *s = &det->samples[det->sample_head];
+    s->dx = dx;
+    s->dy = dy;
+    s->time = now;
+    det->sample_head = (det->sample_head + 1) & SAMPLE_MASK;
+    if (det->sample_count < GESTURE_SAMPLES) det->sample_count++;
+}
+
+// Motion within the last GESTURE_FLICK_MS: the peak velocity of the stroke
+static void flick_sum(gesture_detector_t *det, uint16_t now, int32_t *x, int32_t *y) {
+    *x = 0;
+    *y = 0;
+    for (uint8_t i = 1; i <= det->sample_count; i++) {
+        const gesture_sample_t *s = &det->samples[(det->sample_head - i) & SAMPLE_MASK];
+        if ((uint16_t)(now - s->time) > GESTURE_FLICK_MS) break;
+        *x += s->dx;
+        *y += s->dy;
+    }
+}
+
+static void push_stroke(gesture_detector_t *det, gesture_t g, uint16_t now) {
+    if (det->stroke_count > 0 && (uint16_t)(now - det->last_trigger) > GESTURE_STROKE_GAP_MS) {
+        det->stroke_count = 0;
+    }
+    if (det->stroke_count == GESTURE_MAX_STROKES) {
+        for (uint8_t i = 1; i < GESTURE_MAX_STROKES; i++) {
+            det->strokes[i - 1] = det->strokes[i];
+        }
+        det->stroke_count--;
+    }
+    det->strokes[det->stroke_count++] = g;
+}
+
+void gesture_init(gesture_detector_t *det, int16_t threshold, uint16_t cooldown, bool diagonals) {
+    det->sample_head = 0;
+    det->sample_count = 0;
+    det->drift_x = 0;
+    det->drift_y = 0;
+    det->last_decay = timer_read();
     det->last_trigger = 0;
     det->threshold = threshold;
+    det->flick = threshold / GESTURE_FLICK_DIVISOR;
     det->cooldown = cooldown;
+    det->diagonals = diagonals;
+    det->stroke_count = 0;
+}
+
+gesture_t gesture_direction(int32_t x, int32_t y) {
+    int32_t ax = abs32(x), ay = abs32(y);
+    if (ax == 0 && ay == 0) return GESTURE_NONE;
+
+    if (ay * 256 < ax * OCTANT_TAN_Q8) return x > 0 ? GESTURE_RIGHT : GESTURE_LEFT;
+    if (ax * 256 < ay * OCTANT_TAN_Q8) return y > 0 ? GESTURE_DOWN : GESTURE_UP;
+    if (y < 0) return x > 0 ? GESTURE_UP_RIGHT : GESTURE_UP_LEFT;
+    return x > 0 ? GESTURE_DOWN_RIGHT : GESTURE_DOWN_LEFT;
+}
+
+// Four-way: the larger axis wins, horizontal on a tie
+gesture_t gesture_cardinal(int32_t x, int32_t y) {
+    int32_t ax = abs32(x), ay = abs32(y);
+    if (ax == 0 && ay == 0) return GESTURE_NONE;
+    if (ax >= ay) return x > 0 ? GESTURE_RIGHT : GESTURE_LEFT;
+    return y > 0 ? GESTURE_DOWN : GESTURE_UP;
+}
+
+static gesture_t classify(gesture_detector_t *det, int32_t x, int32_t y) {
+    return det->diagonals ? gesture_direction(x, y) : gesture_cardinal(x, y);
 }
 
 gesture_t gesture_detect(gesture_detector_t *det, int16_t dx, int16_t dy) {
-    accumulator_add(&det->acc, dx, dy);
-    
+    uint16_t now = timer_read();
+
+    decay(det, now);
+    if (dx != 0 || dy != 0) {
+        det->drift_x = clamp_drift(det->drift_x + (int32_t)dx * 256);
+        det->drift_y = clamp_drift(det->drift_y + (int32_t)dy * 256);
+        record_sample(det, dx, dy, now);
+    }
+
     if (!gesture_ready(det)) return GESTURE_NONE;
-    
-    if (det->acc.x > det->threshold) {
-        gesture_trigger(det);
-        return GESTURE_RIGHT;
-    } else if (det->acc.x < -det->threshold) {
-        gesture_trigger(det);
-        return GESTURE_LEFT;
-    } else if (det->acc.y > det->threshold) {
-        gesture_trigger(det);
-        return GESTURE_DOWN;
-    } else if (det->acc.y < -det->threshold) {
+
+    int32_t fx, fy;
+    gesture_t g = GESTURE_NONE;
+    flick_sum(det, now, &fx, &fy);
+
+    if (det->flick > 0 && norm(fx, fy) > det->flick) {
+        g = classify(det, fx, fy);
+    } else if (norm(det->drift_x, det->drift_y) > (int32_t)det->threshold * 256) {
+        g = classify(det, det->drift_x / 256, det->drift_y / 256);
+    }
+
+    if (g != GESTURE_NONE) {
+        push_stroke(det, g, now);
         gesture_trigger(det);
-        return GESTURE_UP;
     }
-    
-    return GESTURE_NONE;
+    return g;
 }
 
 bool gesture_ready(gesture_detector_t *det) {
@@ -37,5 +151,23 @@ bool gesture_ready(gesture_detector_t *det) {
 
 void gesture_trigger(gesture_detector_t *det) {
     det->last_trigger = timer_read();
-    accumulator_reset(&det->acc);
+    det->sample_count = 0;
+    det->drift_x = 0;
+    det->drift_y = 0;
+}
+
+bool gesture_match(gesture_detector_t *det, const gesture_t *pattern, uint8_t len) {
+    if (len == 0 || len > det->stroke_count) return false;
+    if (timer_elapsed(det->last_trigger) > GESTURE_STROKE_GAP_MS) return false;
+
+    const gesture_t *tail = &det->strokes[det->stroke_count - len];
+    for (uint8_t i = 0; i < len; i++) {
+        if (tail[i] != pattern[i]) return false;
+    }
+    det->stroke_count = 0;
+    return true;
+}
+
+void gesture_clear_strokes(gesture_detector_t *det) {
+    det->stroke_count = 0;
 }
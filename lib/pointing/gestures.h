@@ -1,8 +1,8 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
-#include "accumulators.h"
 
+// Slow strokes fire once this much decayed motion builds up
 #ifndef GESTURE_THRESHOLD
 #define GESTURE_THRESHOLD 450
 #endif
@@ -11,22 +11,78 @@
 #define GESTURE_COOLDOWN 300
 #endif
 
+// Flicks fire once threshold / GESTURE_FLICK_DIVISOR counts arrive
+// within GESTURE_FLICK_MS
+#ifndef GESTURE_FLICK_MS
+#define GESTURE_FLICK_MS 24
+#endif
+
+#ifndef GESTURE_FLICK_DIVISOR
+#define GESTURE_FLICK_DIVISOR 4
+#endif
+
+#ifndef GESTURE_SAMPLES
+#define GESTURE_SAMPLES 16
+#endif
+
+// Stale motion leaks away by 1/2^SHIFT per ms (time constant ~2^SHIFT ms)
+#ifndef GESTURE_DECAY_SHIFT
+#define GESTURE_DECAY_SHIFT 9
+#endif
+
+// Strokes closer together than this form one multi-stroke pattern
+#ifndef GESTURE_STROKE_GAP_MS
+#define GESTURE_STROKE_GAP_MS 600
+#endif
+
+#ifndef GESTURE_MAX_STROKES
+#define GESTURE_MAX_STROKES 4
+#endif
+
+_Static_assert((GESTURE_SAMPLES & (GESTURE_SAMPLES - 1)) == 0,
+               "GESTURE_SAMPLES must be a power of two");
+
 typedef enum {
     GESTURE_NONE,
     GESTURE_LEFT,
     GESTURE_RIGHT,
     GESTURE_UP,
-    GESTURE_DOWN
+    GESTURE_DOWN,
+    GESTURE_UP_LEFT,
+    GESTURE_UP_RIGHT,
+    GESTURE_DOWN_LEFT,
+    GESTURE_DOWN_RIGHT
 } gesture_t;
 
 typedef struct {
-    accumulator_t acc;
+    int16_t dx;
+    int16_t dy;
+    uint16_t time;
+} gesture_sample_t;
+
+typedef struct {
+    gesture_sample_t samples[GESTURE_SAMPLES];
+    uint8_t sample_head;
+    uint8_t sample_count;
+    int32_t drift_x;  // Q8 decayed motion
+    int32_t drift_y;
+    uint16_t last_decay;
     uint16_t last_trigger;
     int16_t threshold;
+    int16_t flick;
     uint16_t cooldown;
+    bool diagonals;  // Off: strokes fold onto their dominant axis
+    gesture_t strokes[GESTURE_MAX_STROKES];
+    uint8_t stroke_count;
 } gesture_detector_t;
 
-void gesture_init(gesture_detector_t *det, int16_t threshold, uint16_t cooldown);
+// Callers that only handle LEFT/RIGHT/UP/DOWN pass diagonals = false, so a
+// slanted swipe still counts instead of firing a diagonal they ignore
+void gesture_init(gesture_detector_t *det, int16_t threshold, uint16_t cooldown, bool diagonals);
 gesture_t gesture_detect(gesture_detector_t *det, int16_t dx, int16_t dy);
 bool gesture_ready(gesture_detector_t *det);
 void gesture_trigger(gesture_detector_t *det);
+gesture_t gesture_direction(int32_t x, int32_t y);
+gesture_t gesture_cardinal(int32_t x, int32_t y);
+bool gesture_match(gesture_detector_t *det, const gesture_t *pattern, uint8_t len);
+void gesture_clear_strokes(gesture_detector_t *det);
@@ -0,0 +1,94 @@
+#include "pipeline.h"
+#include QMK_KEYBOARD_H
+
+#ifdef PIPELINE_TIMING_ENABLE
+#include "print.h"
+
+// Cycle counter where the core has one, a free-running timer otherwise
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define DWT_CTRL (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+#define DEMCR (*(volatile uint32_t *)0xE000EDFC)
+#ifdef STM32_SYSCLK
+#define PIPELINE_CLOCK_HZ STM32_SYSCLK
+#else
+#define PIPELINE_CLOCK_HZ 72000000UL
+#endif
+static void clock_start(void) {
+    DEMCR |= (1UL << 24);
+    DWT_CTRL |= 1UL;
+}
+#define CLOCK_NOW() DWT_CYCCNT
+#elif defined(MCU_RP)
+// RP2040 TIMERAWL: 1 MHz, no latching side effects
+#define PIPELINE_CLOCK_HZ 1000000UL
+static void clock_start(void) {}
+#define CLOCK_NOW() (*(volatile uint32_t *)0x40054028)
+#else
+#define PIPELINE_CLOCK_HZ 1000UL
+static void clock_start(void) {}
+#define CLOCK_NOW() timer_read32()
+#endif
+
+static pipeline_stats_t stats[PIPELINE_MAX_STAGES];
+static bool clock_started = false;
+
+const pipeline_stats_t *pipeline_stats(uint8_t index) {
+    return index < PIPELINE_MAX_STAGES ? &stats[index] : NULL;
+}
+
+void pipeline_stats_reset(void) {
+    for (uint8_t i = 0; i < PIPELINE_MAX_STAGES; i++) {
+        stats[i].runs = 0;
+        stats[i].total = 0;
+        stats[i].max = 0;
+    }
+}
+
+void pipeline_stats_print(const pipeline_stage_t *stages, uint8_t count) {
+    uprintf("PIPELINE clock hz %lu\n", (unsigned long)PIPELINE_CLOCK_HZ);
+    for (uint8_t i = 0; i < count && i < PIPELINE_MAX_STAGES; i++) {
+        const pipeline_stats_t *st = &stats[i];
+        uprintf("PIPELINE %s runs %lu avg %lu max %lu\n", stages[i].name,
+                (unsigned long)st->runs,
+                (unsigned long)(st->runs ? st->total / st->runs : 0),
+                (unsigned long)st->max);
+    }
+}
+
+static bool run_stage(const pipeline_stage_t *stage, uint8_t index, report_mouse_t *report) {
+    uint32_t start = CLOCK_NOW();
+    bool more = stage->run(report);
+    uint32_t ticks = CLOCK_NOW() - start;
+
+    if (index < PIPELINE_MAX_STAGES) {
+        pipeline_stats_t *st = &stats[index];
+        st->runs++;
+        st->total += ticks;
+        if (ticks > st->max) st->max = ticks;
+    }
+    return more;
+}
+#else
+#define run_stage(stage, index, report) ((stage)->run(report))
+#endif
+
+report_mouse_t pipeline_run(const pipeline_stage_t *stages, uint8_t count, report_mouse_t report) {
+#ifdef PIPELINE_TIMING_ENABLE
+    if (!clock_started) {
+        clock_start();
+        clock_started = true;
+    }
+#endif
+
+    bool consumed = false;
+    for (uint8_t i = 0; i < count; i++) {
+        const pipeline_stage_t *stage = &stages[i];
+        if (stage->kind == PIPELINE_CONSUME && consumed) continue;
+        if (stage->enabled && !stage->enabled()) continue;
+
+        if (stage->kind == PIPELINE_CONSUME) consumed = true;
+        if (!run_stage(stage, i, &report)) break;
+    }
+    return report;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "report.h"
+
+// Filters may end the pass, transforms always pass the report on, and
+// only the first enabled consumer takes the motion (like an else-if chain)
+typedef enum {
+    PIPELINE_FILTER,
+    PIPELINE_TRANSFORM,
+    PIPELINE_CONSUME
+} pipeline_kind_t;
+
+typedef struct {
+    const char *name;
+    pipeline_kind_t kind;
+    bool (*enabled)(void);                 // NULL = always on
+    bool (*run)(report_mouse_t *report);   // false ends the pass
+} pipeline_stage_t;
+
+#ifndef PIPELINE_MAX_STAGES
+#define PIPELINE_MAX_STAGES 16
+#endif
+
+#define PIPELINE_STAGE(n, k, en, fn) { .name = n, .kind = k, .enabled = en, .run = fn }
+#define PIPELINE_LENGTH(stages) ((uint8_t)(sizeof(stages) / sizeof((stages)[0])))
+
+// Optional per-stage timing, in PIPELINE_CLOCK_HZ ticks
+#ifdef PIPELINE_TIMING_ENABLE
+typedef struct {
+    uint32_t runs;
+    uint32_t total;
+    uint32_t max;
+} pipeline_stats_t;
+
+const pipeline_stats_t *pipeline_stats(uint8_t index);
+void pipeline_stats_reset(void);
+void pipeline_stats_print(const pipeline_stage_t *stages, uint8_t count);
+#endif
+
+report_mouse_t pipeline_run(const pipeline_stage_t *stages, uint8_t count, report_mouse_t report);
@@ -1,25 +1,163 @@
 #include "scroll.h"
+#include QMK_KEYBOARD_H
 
-void scroll_init(scroll_state_t *state, float sensitivity) {
-    state->accum_x = 0.0f;
-    state->accum_y = 0.0f;
-    state->sensitivity = sensitivity;
+#define SAMPLE_MASK (SCROLL_KINETIC_SAMPLES - 1)
+
+static int32_t clamp_accum(int32_t v) {
+    if (v > SCROLL_ACCUM_LIMIT) return SCROLL_ACCUM_LIMIT;
+    if (v < -SCROLL_ACCUM_LIMIT) return -SCROLL_ACCUM_LIMIT;
+    return v;
+}
+
+// Whole wheel units toward zero, capped at +/-limit; the rest stays in *acc
+static int16_t take_axis(int32_t *acc, int16_t limit) {
+    int32_t whole = *acc / 256;
+    if (whole > limit) whole = limit;
+    if (whole < -limit) whole = -limit;
+    *acc -= whole * 256;
+    return (int16_t)whole;
+}
+
+// Detents per second to Q8.8 wheel units per ms
+static int32_t dps_to_vel(int32_t dps, uint16_t resolution) {
+    int32_t vel = dps * resolution * 256 / 1000;
+    return vel > 0 ? vel : 1;
+}
+
+static int32_t abs32(int32_t v) {
+    return v < 0 ? -v : v;
+}
+
+static int32_t clamp_vel(int32_t v, int32_t limit) {
+    if (v > limit) return limit;
+    if (v < -limit) return -limit;
+    return v;
+}
+
+// Exponential decay that always makes progress, even below 2^SHIFT
+static int32_t decay_axis(int32_t v) {
+    int32_t d = v / (1L << SCROLL_KINETIC_DECAY_SHIFT);
+    if (d == 0) d = (v > 0) - (v < 0);
+    return v - d;
+}
+
+static void record_sample(scroll_state_t *state, int16_t dx, int16_t dy) {
+    scroll_sample_t *s = &state->samples[state->sample_head];
+    s->dx = dx;
+    s->dy = dy;
+    s->time = timer_read();
+    state->sample_head = (state->sample_head + 1) & SAMPLE_MASK;
+    if (state->sample_count < SCROLL_KINETIC_SAMPLES) state->sample_count++;
+}
+
+static const scroll_sample_t *newest_sample(scroll_state_t *state) {
+    return &state->samples[(state->sample_head - 1) & SAMPLE_MASK];
+}
+
+// Average speed over the samples within the window before the last one
+static void launch(scroll_state_t *state) {
+    if (state->sample_count == 0) return;
+
+    uint16_t newest = newest_sample(state)->time;
+    uint16_t span = 1;
+    int32_t sum_x = 0, sum_y = 0;
+
+    for (uint8_t i = 1; i <= state->sample_count; i++) {
+        const scroll_sample_t *s = &state->samples[(state->sample_head - i) & SAMPLE_MASK];
+        uint16_t age = (uint16_t)(newest - s->time);
+        if (age > SCROLL_KINETIC_WINDOW_MS) break;
+        sum_x += s->dx;
+        sum_y += s->dy;
+        span = age + 1;
+    }
+    state->sample_count = 0;
+
+    if (sum_x > INT16_MAX) sum_x = INT16_MAX;
+    if (sum_x < -INT16_MAX) sum_x = -INT16_MAX;
+    if (sum_y > INT16_MAX) sum_y = INT16_MAX;
+    if (sum_y < -INT16_MAX) sum_y = -INT16_MAX;
+
+    int32_t vx = sum_x * state->units_per_count / span;
+    int32_t vy = sum_y * state->units_per_count / span;
+    if (abs32(vx) < state->min_vel && abs32(vy) < state->min_vel) return;
+
+    state->vel_x = clamp_vel(vx, state->max_vel);
+    state->vel_y = clamp_vel(vy, state->max_vel);
+    state->last_tick = timer_read();
+    state->coasting = true;
+}
+
+void scroll_init(scroll_state_t *state, uint16_t sensitivity_q8, uint16_t resolution) {
+    if (resolution == 0) resolution = 1;
+    state->accum_x = 0;
+    state->accum_y = 0;
+    state->units_per_count = (int32_t)sensitivity_q8 * resolution;
+    state->sample_head = 0;
+    state->sample_count = 0;
+    state->coasting = false;
+    state->vel_x = 0;
+    state->vel_y = 0;
+    state->min_vel = dps_to_vel(SCROLL_KINETIC_MIN_DPS, resolution);
+    state->stop_vel = dps_to_vel(SCROLL_KINETIC_STOP_DPS, resolution);
+    state->max_vel = dps_to_vel(SCROLL_KINETIC_MAX_DPS, resolution);
+    state->last_tick = 0;
 }
 
 void scroll_accumulate(scroll_state_t *state, int16_t dx, int16_t dy) {
-    state->accum_x += (float)dx * state->sensitivity;
-    state->accum_y += (float)dy * state->sensitivity;
+    if (dx != 0 || dy != 0) {
+        state->coasting = false;
+        record_sample(state, dx, dy);
+    }
+    state->accum_x = clamp_accum(state->accum_x + dx * state->units_per_count);
+    state->accum_y = clamp_accum(state->accum_y + dy * state->units_per_count);
 }
 
-void scroll_consume(scroll_state_t *state, int8_t *h, int8_t *v) {
-    *v = (int8_t)(state->accum_y * -1.0f);
-    *h = (int8_t)(state->accum_x);
-    
-    if (*v != 0) state->accum_y -= (float)(*v * -1);
-    if (*h != 0) state->accum_x -= (float)(*h);
+void scroll_consume(scroll_state_t *state, int16_t *h, int16_t *v, int16_t limit) {
+    *h = take_axis(&state->accum_x, limit);
+    *v = -take_axis(&state->accum_y, limit);
 }
 
 void scroll_reset(scroll_state_t *state) {
-    state->accum_x = 0.0f;
-    state->accum_y = 0.0f;
+    state->accum_x = 0;
+    state->accum_y = 0;
+}
+
+void scroll_release(scroll_state_t *state) {
+    if (!state->coasting) launch(state);
+}
+
+bool scroll_coast(scroll_state_t *state) {
+    if (!state->coasting) {
+        if (state->sample_count == 0) return false;
+        if (timer_elapsed(newest_sample(state)->time) < SCROLL_KINETIC_IDLE_MS) return false;
+        launch(state);
+        if (!state->coasting) return false;
+    }
+
+    uint16_t elapsed = timer_elapsed(state->last_tick);
+    if (elapsed > SCROLL_KINETIC_WINDOW_MS) elapsed = SCROLL_KINETIC_WINDOW_MS;
+    state->last_tick += elapsed;
+
+    while (elapsed--) {
+        state->accum_x = clamp_accum(state->accum_x + state->vel_x);
+        state->accum_y = clamp_accum(state->accum_y + state->vel_y);
+        state->vel_x = decay_axis(state->vel_x);
+        state->vel_y = decay_axis(state->vel_y);
+        if (abs32(state->vel_x) < state->stop_vel && abs32(state->vel_y) < state->stop_vel) {
+            scroll_stop(state);
+            break;
+        }
+    }
+    return true;
+}
+
+bool scroll_coasting(scroll_state_t *state) {
+    return state->coasting;
+}
+
+void scroll_stop(scroll_state_t *state) {
+    state->coasting = false;
+    state->sample_count = 0;
+    state->vel_x = 0;
+    state->vel_y = 0;
 }
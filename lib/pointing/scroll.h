@@ -2,17 +2,88 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#ifndef SCROLL_SENSITIVITY
-#define SCROLL_SENSITIVITY 0.9f
+// Q8.8 wheel detents per sensor count (230 ~= 0.9)
+#ifndef SCROLL_SENSITIVITY_Q8
+#define SCROLL_SENSITIVITY_Q8 230
 #endif
 
+// Wheel units per detent; with hi-res scroll this is the multiplier the
+// report descriptor advertises, so only expand it where QMK is included
+#ifndef SCROLL_RESOLUTION
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define SCROLL_RESOLUTION pointing_device_get_hires_scroll_resolution()
+#else
+#define SCROLL_RESOLUTION 1
+#endif
+#endif
+
+// Backlog beyond this many Q8.8 wheel units per axis is dropped
+#ifndef SCROLL_ACCUM_LIMIT
+#define SCROLL_ACCUM_LIMIT (32767L << 8)
+#endif
+
+// Kinetic scroll: release velocity is estimated from the last few motion
+// reports, then decays by 1/2^SHIFT per ms (time constant ~2^SHIFT ms)
+#ifndef SCROLL_KINETIC_SAMPLES
+#define SCROLL_KINETIC_SAMPLES 16
+#endif
+
+#ifndef SCROLL_KINETIC_WINDOW_MS
+#define SCROLL_KINETIC_WINDOW_MS 50
+#endif
+
+// Ball still for this long counts as a release
+#ifndef SCROLL_KINETIC_IDLE_MS
+#define SCROLL_KINETIC_IDLE_MS 20
+#endif
+
+#ifndef SCROLL_KINETIC_DECAY_SHIFT
+#define SCROLL_KINETIC_DECAY_SHIFT 8
+#endif
+
+// Launch, stop and top speeds, in detents per second
+#ifndef SCROLL_KINETIC_MIN_DPS
+#define SCROLL_KINETIC_MIN_DPS 200
+#endif
+
+#ifndef SCROLL_KINETIC_STOP_DPS
+#define SCROLL_KINETIC_STOP_DPS 10
+#endif
+
+#ifndef SCROLL_KINETIC_MAX_DPS
+#define SCROLL_KINETIC_MAX_DPS 3000
+#endif
+
+_Static_assert((SCROLL_KINETIC_SAMPLES & (SCROLL_KINETIC_SAMPLES - 1)) == 0,
+               "SCROLL_KINETIC_SAMPLES must be a power of two");
+
+typedef struct {
+    int16_t dx;
+    int16_t dy;
+    uint16_t time;
+} scroll_sample_t;
+
 typedef struct {
-    float accum_x;
-    float accum_y;
-    float sensitivity;
+    int32_t accum_x;  // Q8.8 wheel units not yet reported
+    int32_t accum_y;
+    int32_t units_per_count;  // Q8.8 wheel units per sensor count
+    scroll_sample_t samples[SCROLL_KINETIC_SAMPLES];
+    uint8_t sample_head;
+    uint8_t sample_count;
+    bool coasting;
+    int32_t vel_x;  // Q8.8 wheel units per ms while coasting
+    int32_t vel_y;
+    int32_t min_vel;
+    int32_t stop_vel;
+    int32_t max_vel;
+    uint16_t last_tick;
 } scroll_state_t;
 
-void scroll_init(scroll_state_t *state, float sensitivity);
+void scroll_init(scroll_state_t *state, uint16_t sensitivity_q8, uint16_t resolution);
 void scroll_accumulate(scroll_state_t *state, int16_t dx, int16_t dy);
-void scroll_consume(scroll_state_t *state, int8_t *h, int8_t *v);
+void scroll_consume(scroll_state_t *state, int16_t *h, int16_t *v, int16_t limit);
 void scroll_reset(scroll_state_t *state);
+void scroll_release(scroll_state_t *state);
+bool scroll_coast(scroll_state_t *state);
+bool scroll_coasting(scroll_state_t *state);
+void scroll_stop(scroll_state_t *state);
@@ -0,0 +1,70 @@
+#include "sensor.h"
+#include QMK_KEYBOARD_H
+
+static uint16_t base_cpi = 0;
+static uint16_t override_cpi = 0;   // 0 = no override
+static uint16_t written_cpi = 0;
+static bool written_valid = false;
+static uint32_t writes = 0;
+static uint32_t avoided = 0;
+
+static void apply(void) {
+    uint16_t want = override_cpi ? override_cpi : base_cpi;
+    if (written_valid && want == written_cpi) {
+        avoided++;
+        return;
+    }
+    pointing_device_set_cpi(want);
+    written_cpi = want;
+    written_valid = true;
+    writes++;
+}
+
+void sensor_cpi_init(uint16_t cpi) {
+    base_cpi = cpi;
+    override_cpi = 0;
+    written_valid = false;
+    writes = 0;
+    avoided = 0;
+    apply();
+}
+
+void sensor_cpi_set_base(uint16_t cpi) {
+    base_cpi = cpi;
+    apply();
+}
+
+void sensor_cpi_override(uint16_t cpi) {
+    override_cpi = cpi;
+    apply();
+}
+
+void sensor_cpi_release(void) {
+    override_cpi = 0;
+    apply();
+}
+
+// The sensor lost its settings (reset, power cycle); next apply rewrites
+void sensor_cpi_invalidate(void) {
+    written_valid = false;
+}
+
+uint16_t sensor_cpi_base(void) {
+    return base_cpi;
+}
+
+uint16_t sensor_cpi_current(void) {
+    return written_cpi;
+}
+
+bool sensor_cpi_overridden(void) {
+    return override_cpi != 0;
+}
+
+uint32_t sensor_cpi_writes(void) {
+    return writes;
+}
+
+uint32_t sensor_cpi_avoided(void) {
+    return avoided;
+}
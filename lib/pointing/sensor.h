@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Shadow of the CPI last written to the sensor. Callers state what they
+// want as often as they like; only a change reaches the bus.
+//
+// The base CPI is the user's chosen level (DPI cycling). An override
+// (precision mode, remote nav) replaces it until released.
+
+void sensor_cpi_init(uint16_t base_cpi);
+void sensor_cpi_set_base(uint16_t cpi);
+void sensor_cpi_override(uint16_t cpi);
+void sensor_cpi_release(void);
+void sensor_cpi_invalidate(void);
+uint16_t sensor_cpi_base(void);
+uint16_t sensor_cpi_current(void);
+bool sensor_cpi_overridden(void);
+uint32_t sensor_cpi_writes(void);
+uint32_t sensor_cpi_avoided(void);
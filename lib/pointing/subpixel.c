@@ -0,0 +1,36 @@
+#include "subpixel.h"
+
+static int32_t clamp_spill(int32_t v) {
+    if (v > SUBPIXEL_SPILL_LIMIT) return SUBPIXEL_SPILL_LIMIT;
+    if (v < -SUBPIXEL_SPILL_LIMIT) return -SUBPIXEL_SPILL_LIMIT;
+    return v;
+}
+
+// Whole counts toward zero, capped at +/-limit; the rest stays in *acc
+static int16_t take_axis(int32_t *acc, int16_t limit) {
+    int32_t whole = *acc / 256;
+    if (whole > limit) whole = limit;
+    if (whole < -limit) whole = -limit;
+    *acc -= whole * 256;
+    return (int16_t)whole;
+}
+
+void subpixel_init(subpixel_t *sp) {
+    sp->x = 0;
+    sp->y = 0;
+}
+
+void subpixel_add_q8(subpixel_t *sp, int32_t x_q8, int32_t y_q8) {
+    sp->x = clamp_spill(sp->x + x_q8);
+    sp->y = clamp_spill(sp->y + y_q8);
+}
+
+void subpixel_take(subpixel_t *sp, int16_t *x, int16_t *y, int16_t limit) {
+    *x = take_axis(&sp->x, limit);
+    *y = take_axis(&sp->y, limit);
+}
+
+void subpixel_reset(subpixel_t *sp) {
+    sp->x = 0;
+    sp->y = 0;
+}
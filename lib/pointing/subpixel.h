@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Motion beyond this many Q8.8 counts per axis is dropped instead of carried
+#ifndef SUBPIXEL_SPILL_LIMIT
+#define SUBPIXEL_SPILL_LIMIT (1024L << 8)
+#endif
+
+typedef struct {
+    int32_t x;  // Q8.8 motion not yet reported
+    int32_t y;
+} subpixel_t;
+
+void subpixel_init(subpixel_t *sp);
+void subpixel_add_q8(subpixel_t *sp, int32_t x_q8, int32_t y_q8);
+void subpixel_take(subpixel_t *sp, int16_t *x, int16_t *y, int16_t limit);
+void subpixel_reset(subpixel_t *sp);
@@ -2,6 +2,7 @@
  * MOONLANDER COORDINATOR - IMPLEMENTATION
  * ========================================
  * Device behavior rules for Moonlander + Ploopy coordination
+ * The rules themselves are data: see coordinator_rules.def
  * ======================================== */
 
 #include "coordinator.h"
@@ -22,9 +23,100 @@ coordinator_state_t coordinator_state = {
     .ploopy_zoom_active = false,
     .ploopy_media_active = false,
     .macro_recording = false,
-    .current_layer = _BASE
+    .current_layer = _BASE,
+    .ploopy_state = LOCK_STATE_IDLE,
+    .broadcast_pending = false,
+    .pending_state = LOCK_STATE_IDLE,
+    .pending_time = 0,
+    .suppressed_broadcasts = 0
 };
 
+static void coordinator_suppress(uint8_t count) {
+    uint16_t room = UINT16_MAX - coordinator_state.suppressed_broadcasts;
+    coordinator_state.suppressed_broadcasts += count < room ? count : room;
+}
+
+/* ========================================
+ * RULE TABLES (from coordinator_rules.def)
+ * ======================================== */
+
+#define COORDINATOR_STATE_COUNT (LOCK_STATE_SYNC_REQ + 1)
+#define COORDINATOR_KEEP        0xFF  // Layer rule: broadcast nothing
+
+#define COORDINATOR_MODE_SCROLL (1 << 0)
+#define COORDINATOR_MODE_ZOOM   (1 << 1)
+#define COORDINATOR_MODE_MEDIA  (1 << 2)
+
+// Generator macros, one pass of the .def per table
+#define CR_BLANK(...)
+#define CR_LAYER_CELLS(layer, state) \
+    [0][layer] = state, [1][layer] = state, [2][layer] = state, [3][layer] = state, \
+    [4][layer] = state, [5][layer] = state, [6][layer] = state, [7][layer] = state,
+#define CR_KEEP_CELL(state, layer)   [state][layer] = COORDINATOR_KEEP,
+#define CR_MODE_CELL(state, mode)    [state] = COORDINATOR_MODE_##mode,
+#define CR_REMAP_ROW(state, keycode, remap) { state, keycode, remap },
+#define CR_REMAP_MASK(state, keycode, remap) | (1 << (state))
+
+_Static_assert(COORDINATOR_STATE_COUNT == 8, "CR_LAYER_CELLS fills one cell per lock state");
+
+// Dense [line state][layer] → state to broadcast. Layer rules fill whole
+// columns first, then LAYER_KEEP overrides single cells.
+#define LAYER_STATE CR_LAYER_CELLS
+#define LAYER_KEEP  CR_BLANK
+#define PLOOPY_MODE CR_BLANK
+#define KEY_REMAP   CR_BLANK
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Woverride-init"
+static const uint8_t PROGMEM coordinator_layer_rules[COORDINATOR_STATE_COUNT][_LAYER_COUNT] = {
+#include "coordinator_rules.def"
+#undef LAYER_STATE
+#undef LAYER_KEEP
+#define LAYER_STATE CR_BLANK
+#define LAYER_KEEP  CR_KEEP_CELL
+#include "coordinator_rules.def"
+};
+#pragma GCC diagnostic pop
+#undef LAYER_STATE
+#undef LAYER_KEEP
+#undef PLOOPY_MODE
+#undef KEY_REMAP
+
+// Ploopy state → COORDINATOR_MODE_* bits
+#define LAYER_STATE CR_BLANK
+#define LAYER_KEEP  CR_BLANK
+#define PLOOPY_MODE CR_MODE_CELL
+#define KEY_REMAP   CR_BLANK
+static const uint8_t PROGMEM coordinator_mode_rules[COORDINATOR_STATE_COUNT] = {
+#include "coordinator_rules.def"
+};
+#undef PLOOPY_MODE
+#undef KEY_REMAP
+
+// Key remaps, and the Ploopy states that have any
+typedef struct {
+    uint8_t  state;
+    uint16_t keycode;
+    uint16_t remap;
+} coordinator_remap_t;
+
+#define PLOOPY_MODE CR_BLANK
+#define KEY_REMAP   CR_REMAP_ROW
+static const coordinator_remap_t PROGMEM coordinator_key_remaps[] = {
+#include "coordinator_rules.def"
+};
+#undef KEY_REMAP
+
+#define KEY_REMAP   CR_REMAP_MASK
+static const uint8_t coordinator_remap_states = 0
+#include "coordinator_rules.def"
+    ;
+#undef LAYER_STATE
+#undef LAYER_KEEP
+#undef PLOOPY_MODE
+#undef KEY_REMAP
+
+#define COORDINATOR_REMAP_COUNT ((uint8_t)(sizeof(coordinator_key_remaps) / sizeof(coordinator_key_remaps[0])))
+
 /* ========================================
  * INITIALIZATION
  * ======================================== */
@@ -39,6 +131,9 @@ void coordinator_init(void) {
     coordinator_state.ploopy_media_active = false;
     coordinator_state.macro_recording = false;
     coordinator_state.current_layer = _BASE;
+    coordinator_state.ploopy_state = LOCK_STATE_IDLE;
+    coordinator_state.broadcast_pending = false;
+    coordinator_state.suppressed_broadcasts = 0;
     
 #ifdef LOGGING_ENABLE
     LOG_INFO("Coordinator initialized - Moonlander PRIMARY");
@@ -52,54 +147,55 @@ void coordinator_init(void) {
 void coordinator_on_layer_change(uint8_t layer) {
     coordinator_state.current_layer = layer;
     
-    // Broadcast layer state to Ploopy
+    // Look up the state to broadcast for this layer on the current line
+    lock_state_t current = lockstate_cached();
     lock_state_t new_state = LOCK_STATE_IDLE;
+    if (layer < _LAYER_COUNT) {
+        uint8_t rule = pgm_read_byte(&coordinator_layer_rules[current][layer]);
+        new_state = rule == COORDINATOR_KEEP ? current : (lock_state_t)rule;
+    }
     
-    switch (layer) {
-        case _NAV:
-#if COORDINATOR_NAV_ENABLE
-            new_state = LOCK_STATE_ML_NAV;
 #ifdef LOGGING_ENABLE
-            LOG_INFO("NAV layer active - Ploopy precision mode");
+    LOG_INFO("Layer %d - broadcast %s", layer, lockstate_name(new_state));
 #endif
-#endif
-            break;
-        
-        case _NUM:
-#if COORDINATOR_NUM_ENABLE
-            new_state = LOCK_STATE_ML_NUM;
-#ifdef LOGGING_ENABLE
-            LOG_INFO("NUM layer active - Ploopy cursor freeze");
-#endif
-#endif
-            break;
-        
-        case _MEDIA:
-            // Don't broadcast MEDIA layer unless it's user-initiated
-            // (Ploopy-triggered MEDIA layer shouldn't cause feedback loop)
-            if (!coordinator_state.ploopy_media_active) {
-                // User manually activated MEDIA layer - no coordination needed
-            }
-            break;
-        
-        case _BASE:
-        case _FUNC:
-        default:
-            // Return to IDLE for non-coordinated layers
-            new_state = LOCK_STATE_IDLE;
-            break;
+    
+    // Back to what the host already shows: the queued write and the
+    // write that would have undone it both go away
+    if (new_state == current) {
+        if (coordinator_state.broadcast_pending) {
+            coordinator_state.broadcast_pending = false;
+            coordinator_suppress(2);
+        }
+        return;
     }
     
-    // Write state if changed
-    if (new_state != lockstate_cached()) {
-        lockstate_set(new_state);
+#if COORDINATOR_BROADCAST_HOLD > 0
+    // Queue it; coordinator_task() writes it once it has held. A state
+    // already queued keeps its time, a different one replaces it.
+    if (coordinator_state.broadcast_pending) {
+        if (coordinator_state.pending_state == new_state) {
+            return;
+        }
+        coordinator_suppress(1);
     }
+    coordinator_state.broadcast_pending = true;
+    coordinator_state.pending_state = new_state;
+    coordinator_state.pending_time = timer_read();
+#else
+    lockstate_set(new_state);
+#endif
 }
 
 void coordinator_on_macro_change(bool recording) {
     coordinator_state.macro_recording = recording;
     
 #if COORDINATOR_MACRO_ENABLE
+    // The macro state is written now and outranks a queued layer state
+    if (coordinator_state.broadcast_pending) {
+        coordinator_state.broadcast_pending = false;
+        coordinator_suppress(1);
+    }
+    
     if (recording) {
         lockstate_set(LOCK_STATE_ML_MACRO);
 #ifdef LOGGING_ENABLE
@@ -174,22 +270,25 @@ void lockstate_on_remote_change(lock_state_t old_state, lock_state_t new_state)
     if (lockstate_is_ploopy(new_state) || 
         (lockstate_is_ploopy(old_state) && new_state == LOCK_STATE_IDLE)) {
         
-        // Detect state transitions
-        bool scroll_active = (new_state == LOCK_STATE_PA_SCROLL);
-        bool zoom_active = (new_state == LOCK_STATE_PA_ZOOM);
-        bool media_active = (new_state == LOCK_STATE_PA_MEDIA);
+        coordinator_state.ploopy_state = new_state;
+        
+        // Modes the new state turns on, against the ones currently on
+        uint8_t modes = pgm_read_byte(&coordinator_mode_rules[new_state]);
+        uint8_t active = (coordinator_state.ploopy_scroll_active ? COORDINATOR_MODE_SCROLL : 0) |
+                         (coordinator_state.ploopy_zoom_active   ? COORDINATOR_MODE_ZOOM   : 0) |
+                         (coordinator_state.ploopy_media_active  ? COORDINATOR_MODE_MEDIA  : 0);
+        uint8_t changed = modes ^ active;
         
-        // Handle state changes
-        if (scroll_active != coordinator_state.ploopy_scroll_active) {
-            coordinator_on_ploopy_scroll(scroll_active);
+        if (changed & COORDINATOR_MODE_SCROLL) {
+            coordinator_on_ploopy_scroll(modes & COORDINATOR_MODE_SCROLL);
         }
         
-        if (zoom_active != coordinator_state.ploopy_zoom_active) {
-            coordinator_on_ploopy_zoom(zoom_active);
+        if (changed & COORDINATOR_MODE_ZOOM) {
+            coordinator_on_ploopy_zoom(modes & COORDINATOR_MODE_ZOOM);
         }
         
-        if (media_active != coordinator_state.ploopy_media_active) {
-            coordinator_on_ploopy_media(media_active);
+        if (changed & COORDINATOR_MODE_MEDIA) {
+            coordinator_on_ploopy_media(modes & COORDINATOR_MODE_MEDIA);
         }
     }
 }
@@ -204,6 +303,8 @@ void lockstate_on_sync_request(void) {
     coordinator_state.ploopy_zoom_active = false;
     coordinator_state.ploopy_media_active = false;
     coordinator_state.macro_recording = false;
+    coordinator_state.ploopy_state = LOCK_STATE_IDLE;
+    coordinator_state.broadcast_pending = false;
     
     // Return to BASE layer
     layer_clear();
@@ -217,6 +318,17 @@ void lockstate_on_sync_request(void) {
 void coordinator_task(void) {
     // Delegate to lock state polling
     lockstate_task();
+    
+#if COORDINATOR_BROADCAST_HOLD > 0
+    // Broadcast a layer state that has held
+    if (coordinator_state.broadcast_pending &&
+        timer_elapsed(coordinator_state.pending_time) >= COORDINATOR_BROADCAST_HOLD) {
+        coordinator_state.broadcast_pending = false;
+        if (coordinator_state.pending_state != lockstate_cached()) {
+            lockstate_set(coordinator_state.pending_state);
+        }
+    }
+#endif
 }
 
 /* ========================================
@@ -224,32 +336,21 @@ void coordinator_task(void) {
  * ======================================== */
 
 bool coordinator_process_key(uint16_t keycode, keyrecord_t *record) {
-#if COORDINATOR_SCROLL_ENABLE
-    // Arrow key remap when Ploopy scroll mode active
-    if (coordinator_state.ploopy_scroll_active) {
-        switch (keycode) {
-            case KC_UP:
-                if (record->event.pressed) {
-                    tap_code(KC_PGUP);
-                }
-                return false;  // Intercept
-            
-            case KC_DOWN:
-                if (record->event.pressed) {
-                    tap_code(KC_PGDN);
-                }
-                return false;  // Intercept
-            
-            case KC_LEFT:
-            case KC_RIGHT:
-                // Let these pass through (horizontal scroll via Ploopy)
-                return true;
-            
-            default:
-                break;
+    // Nothing remapped in this Ploopy state: one bit test and out
+    if (!(coordinator_remap_states & (1 << coordinator_state.ploopy_state))) {
+        return true;
+    }
+    
+    for (uint8_t i = 0; i < COORDINATOR_REMAP_COUNT; i++) {
+        if (pgm_read_byte(&coordinator_key_remaps[i].state) != coordinator_state.ploopy_state ||
+            pgm_read_word(&coordinator_key_remaps[i].keycode) != keycode) {
+            continue;
+        }
+        if (record->event.pressed) {
+            tap_code16(pgm_read_word(&coordinator_key_remaps[i].remap));
         }
+        return false;  // Intercept
     }
-#endif
     
     return true;  // Process normally
 }
@@ -278,12 +379,12 @@ bool coordinator_ploopy_media(void) {
     return coordinator_state.ploopy_media_active;
 }
 
+uint16_t coordinator_suppressed_broadcasts(void) {
+    return coordinator_state.suppressed_broadcasts;
+}
+
 bool coordinator_keys_overridden(void) {
-#if COORDINATOR_SCROLL_ENABLE
-    return coordinator_state.ploopy_scroll_active;
-#else
-    return false;
-#endif
+    return coordinator_remap_states & (1 << coordinator_state.ploopy_state);
 }
 
 /* ========================================
@@ -299,6 +400,9 @@ void coordinator_debug_dump(void) {
     LOG_INFO("Ploopy Media:  %s", coordinator_state.ploopy_media_active ? "YES" : "NO");
     LOG_INFO("Macro Rec:     %s", coordinator_state.macro_recording ? "YES" : "NO");
     LOG_INFO("Keys Override: %s", coordinator_keys_overridden() ? "YES" : "NO");
+    LOG_INFO("Pending:       %s", coordinator_state.broadcast_pending ?
+             lockstate_name(coordinator_state.pending_state) : "-");
+    LOG_INFO("Suppressed:    %u", coordinator_state.suppressed_broadcasts);
     LOG_INFO("========================");
     lockstate_debug_dump();
 }
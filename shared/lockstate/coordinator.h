@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "quantum.h"
 #include "lockstate.h"
 
 /* ========================================
@@ -22,7 +23,9 @@
 /**
  * @brief Enable/disable specific coordination features
  * 
- * Set these in config.h to customize behavior
+ * Set these in config.h to customize behavior. They gate the matching
+ * rules in coordinator_rules.def, which holds the layer → state,
+ * state → mode and key remap mappings.
  */
 #ifndef COORDINATOR_NAV_ENABLE
 #define COORDINATOR_NAV_ENABLE true   // NAV layer → Ploopy precision mode
@@ -44,6 +47,17 @@
 #define COORDINATOR_MEDIA_ENABLE true // Ploopy media → Moonlander media layer
 #endif
 
+/**
+ * @brief Hold time before a layer state is broadcast
+ * 
+ * A layer must stay put this long before its lock state is written, so a
+ * tapped layer-tap key (NV_SPC) that flicks _NAV on and off never reaches
+ * the host or the Ploopy. Set to 0 to broadcast every layer change at once.
+ */
+#ifndef COORDINATOR_BROADCAST_HOLD
+#define COORDINATOR_BROADCAST_HOLD 80  // ms
+#endif
+
 /* ========================================
  * CORE API
  * ======================================== */
@@ -60,7 +74,9 @@ void coordinator_init(void);
  * @brief Handle Moonlander layer changes
  * 
  * Call in layer_state_set_user() hook
- * Broadcasts layer state to Ploopy via lock state
+ * Queues the layer's lock state; coordinator_task() broadcasts it to
+ * Ploopy once it has held for COORDINATOR_BROADCAST_HOLD. A newer change
+ * replaces the queued one, and a return to the broadcast state drops it.
  * 
  * @param layer New active layer (0-5: BASE/NAV/NUM/FUNC/MACRO/MEDIA)
  */
@@ -80,7 +96,9 @@ void coordinator_on_macro_change(bool recording);
  * @brief Process coordinator tasks
  * 
  * Call in matrix_scan_user() for polling
- * Delegates to lockstate_task() and handles coordination logic
+ * Delegates to lockstate_task() and broadcasts a held layer state
+ * Pair with lockstate_led_update() in led_update_user() so Ploopy
+ * changes are handled on the next scan instead of the next poll
  */
 void coordinator_task(void);
 
@@ -135,6 +153,7 @@ void coordinator_on_ploopy_media(bool active);
  * 
  * Call in process_record_user() BEFORE normal keycode handling
  * Intercepts keys for coordination features (e.g., arrow key remap)
+ * Returns at once when the Ploopy state has no KEY_REMAP rules
  * 
  * @param keycode Key being pressed/released
  * @param record Key record with event data
@@ -167,6 +186,17 @@ bool coordinator_ploopy_zooming(void);
  */
 bool coordinator_ploopy_media(void);
 
+/**
+ * @brief Count layer transitions that never reached the host
+ * 
+ * Each queued broadcast that was replaced or dropped counts once, and so
+ * does the change that dropped it by returning to the broadcast state:
+ * a tapped NV_SPC saves two lock writes and counts two.
+ * 
+ * @return Suppressed transitions since coordinator_init()
+ */
+uint16_t coordinator_suppressed_broadcasts(void);
+
 /**
  * @brief Check if coordination has overridden normal key behavior
  * 
@@ -200,6 +230,11 @@ typedef struct {
     bool ploopy_media_active;
     bool macro_recording;
     uint8_t current_layer;
+    lock_state_t ploopy_state;      // Ploopy state the modes and remaps follow
+    bool broadcast_pending;         // pending_state waiting out the hold
+    lock_state_t pending_state;
+    uint16_t pending_time;          // Layer change that queued it
+    uint16_t suppressed_broadcasts; // Saturates
 } coordinator_state_t;
 
 extern coordinator_state_t coordinator_state;
@@ -0,0 +1,54 @@
+/* ========================================
+ * LOCK FRAME RECEIVER - IMPLEMENTATION
+ * ========================================
+ * Feeds the lib/ipc/lockframe_rx decoder from lockstate_intercept()
+ * ======================================== */
+
+#include "lockframe.h"
+#include QMK_KEYBOARD_H
+#include <string.h>
+
+/* ========================================
+ * INTERNAL STATE
+ * ======================================== */
+
+static lockframe_rx_t    rx;
+static lockframe_stats_t stats;
+
+/* ========================================
+ * CORE FUNCTIONS
+ * ======================================== */
+
+void lockframe_init(void) {
+    lockframe_rx_init(&rx, &stats);
+    lockframe_stats_reset();
+}
+
+bool lockframe_busy(void) {
+    return rx.mode != LF_RX_IDLE;
+}
+
+const lockframe_stats_t *lockframe_stats(void) {
+    return &stats;
+}
+
+void lockframe_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Sees every LED state before lockstate does, from both the LED report
+// hook and the handling-time check
+bool lockstate_intercept(lock_state_t state) {
+    return lockframe_rx_feed(&rx, state, lockstate.sync_requested);
+}
+
+/* ========================================
+ * TASK LOOP
+ * ======================================== */
+
+void lockframe_task(void) {
+    // Hand the LEDs back to lockstate and let it look at them afresh
+    if (lockframe_rx_expired(&rx, lockstate_get())) {
+        lockstate_led_update(lockstate_get());
+    }
+}
@@ -0,0 +1,57 @@
+/* ========================================
+ * LOCK FRAME RECEIVER - API HEADER
+ * ========================================
+ * Receives multi-byte frames sent over the lock LEDs by lib/ipc/lockframe
+ *
+ * The wire format, frame types, statistics and the decoder itself come
+ * from lib/ipc/lockframe_rx, so both lockstate implementations decode
+ * with the same code. This file only connects that decoder to this
+ * lockstate's intercept hook.
+ *
+ * Receive only: the sender is lib/ipc/lockframe, built on that
+ * lockstate. Needs lockstate_led_update() in led_update_user(): polling
+ * alone misses clock edges.
+ *
+ * Library-only for now: no firmware sends frames, so no keymap links it.
+ * ======================================== */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lockstate.h"
+#include "lib/ipc/lockframe_rx.h"
+
+/* ========================================
+ * CORE API
+ * ======================================== */
+
+/**
+ * @brief Reset the receiver and its statistics
+ *
+ * Call once in keyboard_post_init_user(), after lockstate_init()
+ */
+void lockframe_init(void);
+
+/**
+ * @brief Check if a frame is being received
+ *
+ * @return true from the 111 opener until the line is idle again
+ */
+bool lockframe_busy(void);
+
+/**
+ * @brief Drive receiver timeouts
+ *
+ * Call next to lockstate_task(); hands the LEDs back to lockstate once
+ * the line has been idle for LOCKFRAME_IDLE_MS
+ */
+void lockframe_task(void);
+
+/**
+ * @brief Receiver statistics since lockframe_init()
+ *
+ * sent and aborted stay zero: there is no sender here
+ */
+const lockframe_stats_t *lockframe_stats(void);
+void lockframe_stats_reset(void);